@@ -0,0 +1,64 @@
+""" Benchmark script for loading large graphs.
+
+Generates graphs of repeated conv2d, batch_norm and relu blocks and
+measures the time of composing them and of loading them from json and
+from binary. The attributes of graphs with at least 4096 nodes are
+parsed by multiple threads, the default sizes are on both sides of it.
+
+For example, run the file with:
+`python graph_load_bench.py --num-blocks 400 10000`.
+"""
+import time
+import argparse
+import nnvm
+import nnvm.symbol as sym
+
+
+def get_graph(num_blocks):
+    """Get a graph with num_blocks blocks of 4 operators and 5 variables each."""
+    net = sym.Variable("data")
+    for i in range(num_blocks):
+        name = "block%d" % i
+        net = sym.conv2d(net, channels=64, kernel_size=(3, 3), padding=(1, 1),
+                         use_bias=False, name=name + "_conv")
+        net = sym.batch_norm(net, name=name + "_bn")
+        net = sym.relu(net, name=name + "_relu")
+        net = sym.elemwise_add(net, net, name=name + "_add")
+    return nnvm.graph.create(net)
+
+
+def measure(func, repeat):
+    """Get the best time of func over repeat runs in seconds."""
+    best = None
+    for _ in range(repeat):
+        tic = time.time()
+        func()
+        cost = time.time() - tic
+        best = cost if best is None else min(best, cost)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--num-blocks', type=int, nargs='+', default=[400, 10000],
+                        help="Number of conv2d, batch_norm, relu blocks of each graph.")
+    parser.add_argument('--repeat', type=int, default=3, help="Number of repeative times.")
+    args = parser.parse_args()
+    print('benchmark args: {}'.format(args))
+    print("%8s %10s %10s %10s %10s %14s" % (
+        "nodes", "json(MB)", "compose", "load_json", "load_bin", "json(us/node)"))
+    for num_blocks in args.num_blocks:
+        compose = measure(lambda: get_graph(num_blocks), args.repeat)
+        graph = get_graph(num_blocks)
+        json_str = graph.json()
+        data = graph.binary()
+        load_json = measure(lambda: nnvm.graph.load_json(json_str), args.repeat)
+        load_binary = measure(lambda: nnvm.graph.load_binary(data), args.repeat)
+        num_nodes = graph.index.num_nodes
+        print("%8d %10.1f %9.3fs %9.3fs %9.3fs %14.2f" % (
+            num_nodes, len(json_str) / 1e6, compose, load_json, load_binary,
+            load_json / num_nodes * 1e6))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,88 @@
+""" Benchmark script for int8 quantization on CPU.
+
+The float32 model and the int8 model quantized by calibration on random
+inputs are built for the same target, the script reports the time of
+both, and how often the int8 model agrees with the top-1 prediction of
+the float32 model.
+
+For example, run the file with:
+`python int8_imagenet_bench.py --model=resnet --target=llvm`.
+"""
+import argparse
+import numpy as np
+import tvm
+import nnvm.compiler
+import nnvm.testing
+from tvm.contrib import graph_runtime as runtime
+
+def build_module(net, params, target, data_shape, opt_level):
+    with nnvm.compiler.build_config(opt_level=opt_level):
+        graph, lib, params = nnvm.compiler.build(
+            net, target, shape={"data": data_shape}, params=params)
+    module = runtime.create(graph, lib, tvm.cpu(0))
+    module.set_input(**params)
+    return module
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--model', type=str, required=True,
+                        choices=['resnet', 'mobilenet', 'vgg'],
+                        help="The model type.")
+    parser.add_argument('--target', type=str, default='llvm', help="Compilation target.")
+    parser.add_argument('--opt-level', type=int, default=2, help="Level of optimization.")
+    parser.add_argument('--num-iter', type=int, default=10, help="Number of iteration during benchmark.")
+    parser.add_argument('--num-calib', type=int, default=8, help="Number of calibration inputs.")
+    parser.add_argument('--num-check', type=int, default=32, help="Number of inputs to compare.")
+    args = parser.parse_args()
+    ctx = tvm.cpu(0)
+    batch_size = 1
+    num_classes = 1000
+    image_shape = (3, 224, 224)
+
+    data_shape = (batch_size,) + image_shape
+    out_shape = (batch_size, num_classes)
+    if args.model == 'resnet':
+        net, params = nnvm.testing.resnet.get_workload(
+            batch_size=1, image_shape=image_shape)
+    elif args.model == 'mobilenet':
+        net, params = nnvm.testing.mobilenet.get_workload(
+            batch_size=1, image_shape=image_shape)
+    else:
+        net, params = nnvm.testing.vgg.get_workload(
+            batch_size=1, image_shape=image_shape)
+
+    def sample():
+        return np.random.uniform(-1, 1, size=data_shape).astype("float32")
+
+    dataset = [{"data": sample()} for _ in range(args.num_calib)]
+    ranges = nnvm.compiler.calibrate(net, dataset, {"data": data_shape}, params,
+                                     target=args.target)
+    qnet = nnvm.compiler.quantize(net, ranges)
+    modules = [("float32", build_module(net, dict(params), args.target,
+                                        data_shape, args.opt_level)),
+               ("int8", build_module(qnet, dict(params), args.target,
+                                     data_shape, args.opt_level))]
+
+    print('benchmark args: {}'.format(args))
+    times = []
+    for name, module in modules:
+        module.set_input("data", sample())
+        module.run()
+        ftimer = module.module.time_evaluator("run", ctx, args.num_iter)
+        times.append(ftimer().mean)
+        print('%-8s %.2f ms' % (name, times[-1] * 1000))
+    print('speedup  %.2fx' % (times[0] / times[1]))
+
+    agree = 0
+    for _ in range(args.num_check):
+        data = sample()
+        preds = []
+        for _, module in modules:
+            module.run(data=data)
+            out = module.get_output(0, tvm.nd.empty(out_shape))
+            preds.append(np.argmax(out.asnumpy(), axis=1))
+        agree += int(np.sum(preds[0] == preds[1]))
+    print('top-1 agreement %.1f%%' % (100.0 * agree / (args.num_check * batch_size)))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,65 @@
+"""Builds the model served by the example for several batch sizes.
+
+The variants share one library and one set of parameters, see
+nnvm.compiler.build_multi_batch. The graph of each batch size is saved
+next to them, with a description of the input and output read by the server.
+"""
+from __future__ import print_function
+import argparse
+import os
+from os import path as osp
+
+import nnvm.compiler
+import nnvm.testing
+
+
+EXAMPLE_ROOT = osp.abspath(osp.join(osp.dirname(__file__)))
+LIB_DIR = osp.join(EXAMPLE_ROOT, 'lib')
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--model', type=str, default='mlp', choices=['mlp', 'resnet', 'mobilenet'],
+                        help="The model type.")
+    parser.add_argument('--batch-sizes', type=str, default='1,2,4,8,16',
+                        help="Comma separated batch sizes of the variants.")
+    parser.add_argument('--opt-level', type=int, default=3, help="Level of optimization.")
+    args = parser.parse_args()
+
+    batch_sizes = sorted(int(x) for x in args.batch_sizes.split(','))
+    num_classes = 1000
+    image_shape = (3, 224, 224)
+    if args.model == 'mlp':
+        image_shape = (1, 28, 28)
+        num_classes = 10
+    module = getattr(nnvm.testing, args.model)
+    net, params = module.get_workload(
+        batch_size=1, num_classes=num_classes, image_shape=image_shape)
+    shape = {'data': (1,) + image_shape}
+
+    with nnvm.compiler.build_config(opt_level=args.opt_level):
+        model = nnvm.compiler.build_multi_batch(
+            net, 'llvm', shape, batch_sizes, params=params)
+
+    if not osp.isdir(LIB_DIR):
+        os.mkdir(LIB_DIR)
+    model.lib.export_library(osp.join(LIB_DIR, 'deploy_lib.so'))
+    with open(osp.join(LIB_DIR, 'deploy_params.bin'), 'wb') as f_params:
+        f_params.write(nnvm.compiler.save_param_dict(model.params))
+    for batch_size in batch_sizes:
+        path = osp.join(LIB_DIR, 'deploy_graph_%d.json' % batch_size)
+        with open(path, 'w') as f_graph_json:
+            f_graph_json.write(model.graphs[batch_size].json())
+    # input name, elements of one sample of the input and the output,
+    # followed by the batch sizes.
+    sample_size = 1
+    for x in image_shape:
+        sample_size *= x
+    with open(osp.join(LIB_DIR, 'deploy_meta.txt'), 'w') as f_meta:
+        f_meta.write('data %d %d\n' % (sample_size, num_classes))
+        f_meta.write(' '.join(str(x) for x in batch_sizes) + '\n')
+    print('built %s for batch sizes %s' % (args.model, batch_sizes))
+
+
+if __name__ == '__main__':
+    main()
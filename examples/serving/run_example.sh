@@ -0,0 +1,9 @@
+#!/bin/bash
+
+make
+echo "========================="
+echo "no batching"
+LD_LIBRARY_PATH=../../tvm/lib:${LD_LIBRARY_PATH} bin/server --max-batch 1 "$@"
+echo "========================="
+echo "dynamic batching"
+LD_LIBRARY_PATH=../../tvm/lib:${LD_LIBRARY_PATH} bin/server "$@"
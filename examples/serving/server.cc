@@ -0,0 +1,278 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file server.cc
+ * \brief Dynamic batching inference server with a local load generator.
+ *
+ *  Client threads submit single samples to a queue. The batcher thread
+ *  takes up to max_batch requests once that many are queued, or once the
+ *  oldest request has waited max_latency_us, and runs them on the graph
+ *  runtime of the smallest batch size that fits, padding the batch.
+ *  Each client waits for its reply, then for an exponential think time.
+ */
+#include <dlpack/dlpack.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+/*! \brief A sample waiting for its reply. */
+struct Request {
+  const float* input;
+  float* output;
+  Clock::time_point arrival;
+  std::promise<void> done;
+};
+
+/*! \brief The graph runtime of one batch size. */
+struct Variant {
+  int batch_size;
+  tvm::runtime::Module mod;
+  tvm::runtime::PackedFunc set_input, run, get_output;
+  DLTensor* input;
+  DLTensor* output;
+};
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream fs(path, std::ios::in | std::ios::binary);
+  if (!fs) {
+    std::fprintf(stderr, "cannot open %s\n", path.c_str());
+    std::exit(1);
+  }
+  return std::string(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+}
+
+class BatchServer {
+ public:
+  BatchServer(const std::string& lib_dir, int max_batch, int max_latency_us)
+      : max_latency_(max_latency_us) {
+    std::istringstream meta(ReadFile(lib_dir + "/deploy_meta.txt"));
+    meta >> input_name_ >> input_size_ >> output_size_;
+    tvm::runtime::Module lib =
+        tvm::runtime::Module::LoadFromFile(lib_dir + "/deploy_lib.so");
+    std::string params = ReadFile(lib_dir + "/deploy_params.bin");
+    TVMByteArray params_arr;
+    params_arr.data = params.data();
+    params_arr.size = params.length();
+    const tvm::runtime::PackedFunc* fcreate =
+        tvm::runtime::Registry::Get("tvm.graph_runtime.create");
+    if (fcreate == nullptr) {
+      std::fprintf(stderr, "tvm.graph_runtime.create is not registered, "
+                   "build tvm with USE_GRAPH_RUNTIME=1\n");
+      std::exit(1);
+    }
+    int batch_size;
+    while (meta >> batch_size) {
+      if (!variants_.empty() && variants_.back().batch_size >= max_batch) break;
+      Variant v;
+      v.batch_size = batch_size;
+      std::string graph_json = ReadFile(
+          lib_dir + "/deploy_graph_" + std::to_string(batch_size) + ".json");
+      v.mod = (*fcreate)(graph_json, lib, static_cast<int>(kDLCPU), 0);
+      v.mod.GetFunction("load_params")(params_arr);
+      v.set_input = v.mod.GetFunction("set_input");
+      v.run = v.mod.GetFunction("run");
+      v.get_output = v.mod.GetFunction("get_output");
+      int64_t ishape[] = {batch_size, input_size_};
+      int64_t oshape[] = {batch_size, output_size_};
+      TVMArrayAlloc(ishape, 2, kDLFloat, 32, 1, kDLCPU, 0, &v.input);
+      TVMArrayAlloc(oshape, 2, kDLFloat, 32, 1, kDLCPU, 0, &v.output);
+      variants_.push_back(v);
+    }
+    if (variants_.empty()) {
+      std::fprintf(stderr, "%s/deploy_meta.txt lists no batch size\n", lib_dir.c_str());
+      std::exit(1);
+    }
+    // a batch never exceeds the largest variant.
+    max_batch_ = std::min(max_batch, variants_.back().batch_size);
+    thread_ = std::thread([this]() { this->Loop(); });
+  }
+
+  ~BatchServer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    for (Variant& v : variants_) {
+      TVMArrayFree(v.input);
+      TVMArrayFree(v.output);
+    }
+  }
+
+  int64_t input_size() const { return input_size_; }
+  int64_t output_size() const { return output_size_; }
+  int64_t num_batches() const { return num_batches_; }
+  int64_t num_samples() const { return num_samples_; }
+
+  std::future<void> Submit(Request* req) {
+    std::future<void> ret = req->done.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(req);
+    }
+    cv_.notify_one();
+    return ret;
+  }
+
+ private:
+  void Loop() {
+    std::vector<Request*> batch;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        Clock::time_point deadline = queue_.front()->arrival + max_latency_;
+        cv_.wait_until(lock, deadline, [this]() {
+            return stop_ || queue_.size() >= static_cast<size_t>(max_batch_);
+          });
+        size_t n = std::min(queue_.size(), static_cast<size_t>(max_batch_));
+        batch.assign(queue_.begin(), queue_.begin() + n);
+        queue_.erase(queue_.begin(), queue_.begin() + n);
+      }
+      this->RunBatch(batch);
+    }
+  }
+
+  void RunBatch(const std::vector<Request*>& batch) {
+    int n = static_cast<int>(batch.size());
+    Variant* v = &variants_.back();
+    for (Variant& x : variants_) {
+      if (x.batch_size >= n) {
+        v = &x;
+        break;
+      }
+    }
+    float* input = static_cast<float*>(v->input->data);
+    float* output = static_cast<float*>(v->output->data);
+    for (int i = 0; i < n; ++i) {
+      std::memcpy(input + i * input_size_, batch[i]->input, input_size_ * sizeof(float));
+    }
+    std::memset(input + n * input_size_, 0,
+                (v->batch_size - n) * input_size_ * sizeof(float));
+    v->set_input(input_name_, v->input);
+    v->run();
+    v->get_output(0, v->output);
+    num_batches_ += 1;
+    num_samples_ += n;
+    for (int i = 0; i < n; ++i) {
+      std::memcpy(batch[i]->output, output + i * output_size_, output_size_ * sizeof(float));
+      batch[i]->done.set_value();
+    }
+  }
+
+  std::string input_name_;
+  int64_t input_size_{0}, output_size_{0};
+  std::vector<Variant> variants_;
+  int max_batch_;
+  std::chrono::microseconds max_latency_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request*> queue_;
+  bool stop_{false};
+  std::thread thread_;
+  std::atomic<int64_t> num_batches_{0}, num_samples_{0};
+};
+
+void PrintUsage(const char* prog, const std::map<std::string, std::string>& args) {
+  std::fprintf(stderr, "usage: %s", prog);
+  for (const auto& kv : args) {
+    std::fprintf(stderr, " [%s %s]", kv.first.c_str(), kv.second.c_str());
+  }
+  std::fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+  std::map<std::string, std::string> args = {
+    {"--lib-dir", "lib"}, {"--clients", "16"}, {"--duration", "10"},
+    {"--think-us", "1000"}, {"--max-batch", "16"}, {"--max-latency-us", "2000"},
+    {"--seed", "0"},
+  };
+  for (int i = 1; i < argc; i += 2) {
+    if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+      PrintUsage(argv[0], args);
+      return 0;
+    }
+    // unknown flags and a last flag without value are errors.
+    if (!args.count(argv[i]) || i + 1 == argc) {
+      PrintUsage(argv[0], args);
+      return 1;
+    }
+    args[argv[i]] = argv[i + 1];
+  }
+  int num_clients = std::stoi(args["--clients"]);
+  double duration = std::stod(args["--duration"]);
+  double think_us = std::stod(args["--think-us"]);
+  int seed = std::stoi(args["--seed"]);
+
+  BatchServer server(args["--lib-dir"], std::stoi(args["--max-batch"]),
+                     std::stoi(args["--max-latency-us"]));
+  Clock::time_point start = Clock::now();
+  Clock::time_point stop = start + std::chrono::microseconds(
+      static_cast<int64_t>(duration * 1e6));
+  std::vector<std::vector<double> > latency(num_clients);
+  std::vector<std::thread> clients;
+  for (int c = 0; c < num_clients; ++c) {
+    clients.emplace_back([&, c]() {
+        std::mt19937 rng(seed * num_clients + c);
+        std::uniform_real_distribution<float> value(0, 1);
+        std::exponential_distribution<double> think(1.0 / std::max(think_us, 1.0));
+        std::vector<float> input(server.input_size()), output(server.output_size());
+        while (Clock::now() < stop) {
+          for (float& x : input) x = value(rng);
+          Request req;
+          req.input = input.data();
+          req.output = output.data();
+          req.arrival = Clock::now();
+          server.Submit(&req).wait();
+          latency[c].push_back(std::chrono::duration<double, std::micro>(
+              Clock::now() - req.arrival).count());
+          if (think_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                static_cast<int64_t>(think(rng))));
+          }
+        }
+      });
+  }
+  for (std::thread& t : clients) t.join();
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::vector<double> all;
+  for (const auto& l : latency) all.insert(all.end(), l.begin(), l.end());
+  std::sort(all.begin(), all.end());
+  if (all.empty()) {
+    std::fprintf(stderr, "no request finished\n");
+    return 1;
+  }
+  auto percentile = [&all](double p) {
+    return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+  };
+  std::printf("requests       %zu\n", all.size());
+  std::printf("throughput     %.1f req/s\n", all.size() / elapsed);
+  std::printf("latency p50    %.1f us\n", percentile(0.5));
+  std::printf("latency p99    %.1f us\n", percentile(0.99));
+  std::printf("mean batch     %.2f\n",
+              static_cast<double>(server.num_samples()) / server.num_batches());
+  return 0;
+}
@@ -0,0 +1,200 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file attr_dict.h
+ * \brief Compact attribute dictionary of the nodes.
+ */
+#ifndef NNVM_ATTR_DICT_H_
+#define NNVM_ATTR_DICT_H_
+
+#include <dmlc/json.h>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nnvm {
+
+/*!
+ * \brief String dictionary stored as a vector sorted by key,
+ *  the type of NodeAttrs::dict.
+ *
+ *  It provides the subset of the std::unordered_map interface used
+ *  on NodeAttrs::dict, and converts from and to std::unordered_map.
+ *  A node only has a handful of attributes, so a single allocation
+ *  with short strings stored inline costs much less than the buckets
+ *  and the per entry nodes of a hash map, and binary search over a
+ *  few entries is as fast as hashing.
+ */
+class CompactAttrDict {
+ public:
+  /*! \brief key type */
+  using key_type = std::string;
+  /*! \brief mapped type */
+  using mapped_type = std::string;
+  /*! \brief entry type, the key must not be changed in place */
+  using value_type = std::pair<std::string, std::string>;
+  /*! \brief size type */
+  using size_type = size_t;
+  /*! \brief iterator */
+  using iterator = std::vector<value_type>::iterator;
+  /*! \brief const iterator */
+  using const_iterator = std::vector<value_type>::const_iterator;
+  /*! \brief default constructor */
+  CompactAttrDict() = default;
+  /*!
+   * \brief constructor from a range of key value pairs.
+   *  Later duplicate keys are ignored, as in std::unordered_map.
+   */
+  template<typename Iter>
+  CompactAttrDict(Iter begin, Iter end) {
+    this->insert(begin, end);
+  }
+  /*! \brief constructor from initializer list */
+  CompactAttrDict(std::initializer_list<value_type> init)
+      : CompactAttrDict(init.begin(), init.end()) {}
+  /*! \brief constructor from an unordered_map */
+  CompactAttrDict(const std::unordered_map<std::string, std::string>& dict)  // NOLINT(*)
+      : CompactAttrDict(dict.begin(), dict.end()) {}
+  /*! \return the content as an unordered_map */
+  operator std::unordered_map<std::string, std::string>() const {
+    return std::unordered_map<std::string, std::string>(data_.begin(), data_.end());
+  }
+  /*! \return begin iterator, in increasing order of keys */
+  iterator begin() { return data_.begin(); }
+  /*! \return end iterator */
+  iterator end() { return data_.end(); }
+  /*! \return begin iterator, in increasing order of keys */
+  const_iterator begin() const { return data_.begin(); }
+  /*! \return end iterator */
+  const_iterator end() const { return data_.end(); }
+  /*! \return number of entries */
+  size_t size() const { return data_.size(); }
+  /*! \return whether the dict is empty */
+  bool empty() const { return data_.empty(); }
+  /*! \brief remove all the entries */
+  void clear() { data_.clear(); }
+  /*! \brief reserve space for n entries */
+  void reserve(size_t n) { data_.reserve(n); }
+  /*! \brief swap content with other */
+  void swap(CompactAttrDict& other) { data_.swap(other.data_); }
+  /*! \return iterator to the entry of key, or end() */
+  iterator find(const std::string& key) {
+    iterator it = LowerBound(key);
+    return (it != data_.end() && it->first == key) ? it : data_.end();
+  }
+  /*! \return iterator to the entry of key, or end() */
+  const_iterator find(const std::string& key) const {
+    return const_cast<CompactAttrDict*>(this)->find(key);
+  }
+  /*! \return number of entries with key, 0 or 1 */
+  size_t count(const std::string& key) const {
+    return this->find(key) != data_.end() ? 1 : 0;
+  }
+  /*!
+   * \return the value of key.
+   * \throw std::out_of_range if key is not in the dict.
+   */
+  std::string& at(const std::string& key) {
+    iterator it = this->find(key);
+    if (it == data_.end()) {
+      throw std::out_of_range("CompactAttrDict::at: cannot find key " + key);
+    }
+    return it->second;
+  }
+  /*!
+   * \return the value of key.
+   * \throw std::out_of_range if key is not in the dict.
+   */
+  const std::string& at(const std::string& key) const {
+    return const_cast<CompactAttrDict*>(this)->at(key);
+  }
+  /*! \return the value of key, inserted as empty string if missing */
+  std::string& operator[](const std::string& key) {
+    iterator it = LowerBound(key);
+    if (it == data_.end() || it->first != key) {
+      it = data_.emplace(it, key, std::string());
+    }
+    return it->second;
+  }
+  /*!
+   * \brief insert an entry if its key is not in the dict.
+   * \return the entry of the key and whether it is inserted.
+   */
+  std::pair<iterator, bool> insert(value_type kv) {
+    iterator it = LowerBound(kv.first);
+    if (it != data_.end() && it->first == kv.first) {
+      return std::make_pair(it, false);
+    }
+    return std::make_pair(data_.emplace(it, std::move(kv)), true);
+  }
+  /*! \brief insert a range of entries, existing keys are kept */
+  template<typename Iter>
+  void insert(Iter begin, Iter end) {
+    for (; begin != end; ++begin) {
+      this->insert(value_type(begin->first, begin->second));
+    }
+  }
+  /*! \brief construct and insert an entry, see insert */
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return this->insert(value_type(std::forward<Args>(args)...));
+  }
+  /*! \return number of removed entries, 0 or 1 */
+  size_t erase(const std::string& key) {
+    iterator it = this->find(key);
+    if (it == data_.end()) return 0;
+    data_.erase(it);
+    return 1;
+  }
+  /*! \return the iterator following the removed entry */
+  iterator erase(const_iterator pos) {
+    return data_.erase(pos);
+  }
+  /*! \return whether the two dicts have the same entries */
+  bool operator==(const CompactAttrDict& other) const {
+    return data_ == other.data_;
+  }
+  /*! \return whether the two dicts differ */
+  bool operator!=(const CompactAttrDict& other) const {
+    return data_ != other.data_;
+  }
+  /*!
+   * \brief save the dict as a json object.
+   * \param writer the json writer.
+   */
+  void Save(dmlc::JSONWriter* writer) const {
+    writer->BeginObject(false);
+    for (const value_type& kv : data_) {
+      writer->WriteObjectKeyValue(kv.first, kv.second);
+    }
+    writer->EndObject();
+  }
+  /*!
+   * \brief load the dict from a json object.
+   * \param reader the json reader.
+   */
+  void Load(dmlc::JSONReader* reader) {
+    data_.clear();
+    reader->BeginObject();
+    std::string key;
+    while (reader->NextObjectItem(&key)) {
+      reader->Read(&((*this)[key]));
+    }
+  }
+
+ private:
+  /*! \return the first entry whose key is not less than key */
+  iterator LowerBound(const std::string& key) {
+    return std::lower_bound(
+        data_.begin(), data_.end(), key,
+        [](const value_type& kv, const std::string& k) { return kv.first < k; });
+  }
+  /*! \brief the entries sorted by key */
+  std::vector<value_type> data_;
+};
+
+}  // namespace nnvm
+#endif  // NNVM_ATTR_DICT_H_
@@ -354,6 +354,37 @@ NNVM_DLL int NNGraphGetJSONAttr(GraphHandle handle,
                                 const char** json_out,
                                 int *success);
 
+/*!
+ * \brief Set a string attribute from raw bytes.
+ *  Unlike NNGraphSetJSONAttr, the bytes can contain any character.
+ *
+ * \param handle The graph handle.
+ * \param key The key to the attribute.
+ * \param data The bytes of the attribute.
+ * \param size The number of bytes.
+ * \return 0 when success, -1 when failure happens
+ */
+NNVM_DLL int NNGraphSetBytesAttr(GraphHandle handle,
+                                 const char* key,
+                                 const char* data,
+                                 nn_uint size);
+
+/*!
+ * \brief Get the raw bytes of a string attribute.
+ *
+ * \param handle The graph handle.
+ * \param key The key to the attribute.
+ * \param out_data The bytes of the attribute.
+ * \param out_size The number of bytes.
+ * \param success Whether the result is contained in out.
+ * \return 0 when success, -1 when failure happens
+ */
+NNVM_DLL int NNGraphGetBytesAttr(GraphHandle handle,
+                                 const char* key,
+                                 const char** out_data,
+                                 nn_uint* out_size,
+                                 int *success);
+
 /*!
  * \brief Set a attribute whose type is std::vector<NodeEntry> in c++
  * This feature allows pass List of symbolic variables for gradient request.
@@ -380,6 +411,20 @@ NNVM_DLL int NNGraphApplyPasses(GraphHandle src,
                                 nn_uint num_pass,
                                 const char** pass_names,
                                 GraphHandle *dst);
+/*!
+ * \brief Apply passes on the src graph and record the profile of each pass.
+ *  The profile is the graph attribute "pass_profile" of dst,
+ *  a list of records that can be read by NNGraphGetJSONAttr.
+ * \param src The source graph handle.
+ * \param num_pass The number of pass to be applied.
+ * \param pass_names The names of the pass.
+ * \param dst The result graph.
+ * \return 0 when success, -1 when failure happens
+ */
+NNVM_DLL int NNGraphApplyPassesProfile(GraphHandle src,
+                                       nn_uint num_pass,
+                                       const char** pass_names,
+                                       GraphHandle *dst);
 
 #ifdef __cplusplus
 } /* end extern "C" */
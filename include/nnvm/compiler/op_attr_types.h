@@ -87,6 +87,25 @@ using FTVMLayoutRequest = std::function<bool (const NodeAttrs& attrs,
                                               std::vector<TLayoutInfo> *ilayouts,
                                               std::vector<TLayoutInfo> *olayouts)>;
 
+/*!
+ * \brief Whether the operator can compute in a proposed layout.
+ *
+ *  This is used to propagate layouts, e.g. blocked NCHW16c, through
+ *  operators whose semantics do not depend on the layout.
+ *
+ * \param attrs The attribute of the node.
+ * \param ishapes The input shapes in the default layout.
+ * \param ilayouts The input layouts. On entry, the first element is the
+ *  proposed layout of the first input and the rest are default.
+ *  On return, the input layouts that the node request.
+ * \param olayouts The output layouts that the node produce.
+ * \return bool Whether the proposed layout is supported.
+ */
+using FTVMLayoutSupport = std::function<bool (const NodeAttrs& attrs,
+                                              const std::vector<TShape>& ishapes,
+                                              std::vector<TLayoutInfo> *ilayouts,
+                                              std::vector<TLayoutInfo> *olayouts)>;
+
 /*!
  * \brief Transform from normal operator to vectorized operator
  * \param node The source node.
@@ -94,6 +113,23 @@ using FTVMLayoutRequest = std::function<bool (const NodeAttrs& attrs,
  */
 using FTVMVectorizedOp = std::function<nnvm::NodePtr (const nnvm::Node* node)>;
 
+/*!
+ * \brief Estimate the floating point operations of the operator.
+ *
+ *  A multiply-add counts as two operations, and an operator that only
+ *  moves data, e.g. reshape or transpose, has zero cost. The bytes
+ *  read and written are derived from the shapes and types by the
+ *  EstimateCost pass.
+ *
+ * \param attrs The attribute of the node.
+ * \param ishapes The input shapes.
+ * \param oshapes The output shapes.
+ * \return The number of floating point operations.
+ */
+using FEstimateCost = std::function<uint64_t (const NodeAttrs& attrs,
+                                              const std::vector<TShape>& ishapes,
+                                              const std::vector<TShape>& oshapes)>;
+
 }  // namespace compiler
 }  // namespace nnvm
 #endif  // NNVM_COMPILER_OP_ATTR_TYPES_H_
@@ -10,6 +10,7 @@
 #include <string>
 #include <utility>
 #include <algorithm>
+#include <limits>
 #include <unordered_map>
 #include <unordered_set>
 #include "./base.h"
@@ -76,6 +77,65 @@ class Graph {
   mutable std::shared_ptr<const IndexedGraph> indexed_graph_;
 };
 
+/*!
+ * \brief Flat open addressing hash table from node pointer to node id.
+ *  The slots are stored in one array with linear probing, so a lookup
+ *  is a hash and usually a single cache line, and inserts allocate only
+ *  when the table doubles.
+ */
+class NodeIndexMap {
+ public:
+  /*! \brief value returned by Find for a missing node */
+  static constexpr uint32_t kNotFound = std::numeric_limits<uint32_t>::max();
+  /*!
+   * \brief Insert a node that is not in the table.
+   * \param node The node.
+   * \param nid The id of the node.
+   */
+  void Insert(const nnvm::Node* node, uint32_t nid);
+  /*!
+   * \brief Find the id of a node.
+   * \param node The node.
+   * \return the id of the node, or kNotFound, also for nullptr.
+   */
+  inline uint32_t Find(const nnvm::Node* node) const {
+    // nullptr marks the empty slots, it is never in the table.
+    if (node == nullptr || slots_.empty()) return kNotFound;
+    for (size_t i = Hash(node) & mask_;; i = (i + 1) & mask_) {
+      const Slot& s = slots_[i];
+      if (s.node == node) return s.nid;
+      if (s.node == nullptr) return kNotFound;
+    }
+  }
+  /*! \return number of nodes in the table */
+  inline size_t size() const {
+    return size_;
+  }
+
+ private:
+  /*! \brief a slot of the table, empty if node is nullptr */
+  struct Slot {
+    const nnvm::Node* node;
+    uint32_t nid;
+  };
+  /*! \brief mix the pointer bits, the low bits are mostly alignment */
+  static inline size_t Hash(const nnvm::Node* node) {
+    uint64_t x = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(node));
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+  }
+  /*! \brief rebuild the table with the given capacity */
+  void Rehash(size_t capacity);
+  // the slots, size is a power of two
+  std::vector<Slot> slots_;
+  // size of slots minus one
+  size_t mask_{0};
+  // number of used slots
+  size_t size_{0};
+};
+
 /*!
  * \brief Auxiliary data structure to index a graph.
  *  It maps Nodes in the graph to consecutive integers node_id.
@@ -149,7 +209,11 @@ class IndexedGraph {
    * \return the node index.
    */
   inline uint32_t node_id(const nnvm::Node* node) const {
-    return node2index_.at(node);
+    uint32_t nid = node2index_.Find(node);
+    CHECK_NE(nid, NodeIndexMap::kNotFound)
+        << "Node " << (node != nullptr ? node->attrs.name : std::string("nullptr"))
+        << " is not in the indexed graph";
+    return nid;
   }
   /*!
    * \brief Get the corresponding Node structure for a given node_id.
@@ -182,7 +246,7 @@ class IndexedGraph {
 
   /*! \return whether a node is existed in the indexed graph */
   inline bool exist(const nnvm::Node* node) const {
-    return node2index_.count(node);
+    return node2index_.Find(node) != NodeIndexMap::kNotFound;
   }
 
   // disalllow copy assign
@@ -204,7 +268,7 @@ class IndexedGraph {
   // space to store the outputs entries
   std::vector<NodeEntry> outputs_;
   // mapping from node to index.
-  std::unordered_map<const nnvm::Node*, uint32_t> node2index_;
+  NodeIndexMap node2index_;
   // CSR pointer of node entries
   std::vector<size_t> entry_rptr_;
   // space to store input entries of each
@@ -6,6 +6,7 @@
 #ifndef NNVM_GRAPH_ATTR_TYPES_H_
 #define NNVM_GRAPH_ATTR_TYPES_H_
 
+#include <dmlc/json.h>
 #include <vector>
 #include <string>
 #include "./tuple.h"
@@ -91,6 +92,75 @@ using DeviceAssignMap = std::unordered_map<std::string, int>;
  */
 using StorageVector = std::vector<int>;
 
+/*!
+ * \brief The result holder of the parallel schedule of each node in the graph.
+ *
+ * \note Provided by Pass "ParallelSchedule", indexed by node id and -1 for variables.
+ *  - graph.attrs["node_level"]: the nodes of a level only depend on nodes of
+ *    earlier levels and can run concurrently once the earlier levels are done.
+ *  - graph.attrs["node_stream"]: the stream of the node. The nodes of a stream,
+ *    except the last one, form a dependency chain and can run on one thread.
+ *  - graph.attrs["node_dep_count"]: number of distinct operator nodes
+ *    the node depends on.
+ *
+ *  PlanMemory does not reuse a storage until all the nodes that touched
+ *  it are in earlier levels. The memory plan is therefore only safe when
+ *  the levels run one after another with a barrier between them, and the
+ *  nodes of a level run concurrently. A dataflow runtime that starts a
+ *  node as soon as its node_dep_count inputs are done may run nodes of
+ *  different levels at the same time, and overwrite a storage in use.
+ *
+ * \code
+ *  Graph g = ApplyPasses(src_graph, {"ParallelSchedule", "PlanMemory"});
+ *  const ScheduleVector& level = g.GetAttr<ScheduleVector>("node_level");
+ *  // get level by node_id
+ *  int node_level = level[g.indexed_graph().node_id(my_node)];
+ * \endcode
+ */
+using ScheduleVector = std::vector<int>;
+
+/*!
+ * \brief Profile record of a pass, or of a phase inside a pass.
+ *  The names of the phases are prefixed with the pass name, as in
+ *  "GraphFuseCompile.lower", and their node counts are zero.
+ */
+struct PassProfileEntry {
+  /*! \brief name of the pass or phase */
+  std::string name;
+  /*! \brief wall time in milliseconds */
+  double time_ms{0};
+  /*! \brief number of nodes before the pass */
+  uint64_t num_nodes_before{0};
+  /*! \brief number of nodes after the pass */
+  uint64_t num_nodes_after{0};
+  /*! \brief number of node entries before the pass */
+  uint64_t num_entries_before{0};
+  /*! \brief number of node entries after the pass */
+  uint64_t num_entries_after{0};
+  /*!
+   * \brief net bytes allocated on the heap during the pass,
+   *  the memory freed is subtracted. Zero if the allocator cannot tell.
+   */
+  int64_t allocated_bytes{0};
+
+  void Save(dmlc::JSONWriter* writer) const;
+  void Load(dmlc::JSONReader* reader);
+};
+
+/*!
+ * \brief The profile of each pass applied by ApplyPasses, in order.
+ *
+ * \note Stored under graph.attrs["pass_profile"] of the result of
+ *  ApplyPasses when it is called with profile = true. The attribute
+ *  of the source graph is dropped, it never enables profiling.
+ *
+ * \code
+ *  Graph g = ApplyPasses(src_graph, {"InferShape", "PlanMemory"}, true);
+ *  const PassProfile& profile = g.GetAttr<PassProfile>("pass_profile");
+ * \endcode
+ */
+using PassProfile = std::vector<PassProfileEntry>;
+
 }  // namespace nnvm
 
 #endif  // NNVM_GRAPH_ATTR_TYPES_H_
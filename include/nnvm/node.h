@@ -13,6 +13,7 @@
 #include "./base.h"
 #include "./op.h"
 #include "./c_api.h"
+#include "./attr_dict.h"
 
 namespace nnvm {
 
@@ -70,6 +71,13 @@ struct NodeEntryEqual {
 template<typename ValueType>
 using NodeEntryMap = std::unordered_map<NodeEntry, ValueType, NodeEntryHash, NodeEntryEqual>;
 
+/*!
+ * \brief The type of NodeAttrs::dict.
+ *  A sorted vector with the interface of std::unordered_map used on
+ *  the dict, which saves memory on large graphs, see attr_dict.h.
+ */
+using NodeAttrDict = CompactAttrDict;
+
 /*!
  * \brief The attributes of the current operation node.
  *  Usually are additional parameters like axis,
@@ -83,7 +91,7 @@ struct NodeAttrs {
   /*! \brief name of the node */
   std::string name;
   /*! \brief The dictionary representation of attributes */
-  std::unordered_map<std::string, std::string> dict;
+  NodeAttrDict dict;
   /*!
    * \brief A parsed version of attributes,
    * This is generated if OpProperty.attr_parser is registered.
@@ -124,9 +132,52 @@ class NNVM_DLL Node {
   inline uint32_t num_inputs() const;
   /*!
    * \brief create a new empty shared_ptr of Node.
+   *  The node is allocated from the arena of the innermost
+   *  NodeArenaScope of the calling thread, if there is one.
    * \return a created empty node.
    */
   static NodePtr Create();
+  /*!
+   * \brief create a new empty shared_ptr of Node for a variable.
+   *  Variables are never allocated from a node arena. They are often
+   *  shared by the graphs transformed from a loaded graph, and would
+   *  keep all the pages of its arena alive.
+   * \return a created empty node.
+   */
+  static NodePtr CreateVariable();
+};
+
+// Forward declare node arena.
+class NodeArena;
+
+/*!
+ * \brief Scope in which Node::Create allocates from a new node arena.
+ *
+ *  The nodes created by the current thread in the scope are packed in
+ *  pages of the arena, growing from a few nodes to large pages, which makes creation and deletion cheaper
+ *  and keeps the nodes of a graph close in memory for traversals.
+ *  Each node keeps the arena alive, so the nodes are ordinary NodePtr
+ *  that can outlive the scope; the pages are released with the last node.
+ *  Variables are allocated outside the arena, see Node::CreateVariable.
+ *
+ * \code
+ *   {
+ *     NodeArenaScope scope;
+ *     // all the nodes of the loaded graph share one arena
+ *     ret = LoadJSON(json);
+ *   }
+ * \endcode
+ */
+class NNVM_DLL NodeArenaScope {
+ public:
+  NodeArenaScope();
+  ~NodeArenaScope();
+  NodeArenaScope(const NodeArenaScope&) = delete;
+  NodeArenaScope& operator=(const NodeArenaScope&) = delete;
+
+ private:
+  /*! \brief the arena of the enclosing scope */
+  std::shared_ptr<NodeArena> prev_;
 };
 
 /*!
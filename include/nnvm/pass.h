@@ -8,8 +8,11 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
+#include <string>
 #include "./base.h"
 #include "./graph.h"
+#include "./graph_attr_types.h"
 
 namespace nnvm {
 
@@ -28,12 +31,59 @@ typedef std::function<Graph (Graph src)> PassFunction;
 
 /*!
  * \brief Apply a series of pass transformations on the input graph.
+ *
+ *  When a graph attribute a pass depends on is missing, or pending
+ *  inputs for it are set as attribute_name + "_inputs" (e.g. "shape_inputs"),
+ *  the pass that provides the attribute is applied first.
+ *  A pass that does not change the graph and was already applied in
+ *  the same call since the last structural change is not run again.
+ *
  * \param src The graph to be transformed.
  * \param passes A list of pass names to be applied.
+ * \param profile Whether to record the PassProfile of the passes.
  * \return The transformed graph
  */
 Graph ApplyPasses(Graph src,
-                  const std::vector<std::string>& passes);
+                  const std::vector<std::string>& passes,
+                  bool profile = false);
+
+/*!
+ * \brief Profile a phase of a pass while in scope.
+ *
+ *  The record is appended to the profile of the pass running on the
+ *  calling thread when ApplyPasses profiles the passes, and the scope
+ *  does nothing otherwise.
+ *
+ * \code
+ *  Graph MyPass(Graph src) {
+ *    {
+ *      PassPhaseProfiler phase("MyPass.lower");
+ *      // lowering
+ *    }
+ *  }
+ * \endcode
+ */
+class NNVM_DLL PassPhaseProfiler {
+ public:
+  /*!
+   * \brief start profiling a phase.
+   * \param name The name of the phase.
+   */
+  explicit PassPhaseProfiler(std::string name);
+  ~PassPhaseProfiler();
+  PassPhaseProfiler(const PassPhaseProfiler&) = delete;
+  PassPhaseProfiler& operator=(const PassPhaseProfiler&) = delete;
+
+ private:
+  /*! \brief phases to append to, nullptr if not profiling */
+  std::vector<PassProfileEntry>* phases_{nullptr};
+  /*! \brief name of the phase */
+  std::string name_;
+  /*! \brief start time in seconds */
+  double start_time_{0};
+  /*! \brief heap bytes in use at start */
+  int64_t start_bytes_{0};
+};
 
 /*!
  * \brief Apply one pass to the graph.
@@ -42,6 +42,28 @@ inline std::string SaveJSON(Graph graph) {
 }
 
 
+/*!
+ * \brief Load a graph from binary format, redirects to "LoadBinary" pass.
+ * \param bytes The bytes saved by SaveBinary.
+ * \return Loaded graph.
+ */
+inline Graph LoadBinary(const std::string& bytes) {
+  Graph ret;
+  ret.attrs["binary"] = std::make_shared<any>(bytes);
+  return ApplyPass(ret, "LoadBinary");
+}
+
+/*!
+ * \brief Save a graph to binary format, redirects to "SaveBinary" pass.
+ *  The binary format holds the same content as SaveJSON.
+ * \param graph The graph to be saved.
+ * \return The bytes of the graph.
+ */
+inline std::string SaveBinary(Graph graph) {
+  Graph ret = ApplyPass(std::move(graph), "SaveBinary");
+  return ret.GetAttr<std::string>("binary");
+}
+
 /*!
  * \brief Print graph ir
  * \param graph The graph to be printed
@@ -9,6 +9,7 @@
 #include <dmlc/base.h>
 #include <dmlc/parameter.h>
 #include <nnvm/tuple.h>
+#include "./tensor.h"
 
 namespace nnvm {
 namespace top {
@@ -29,12 +30,17 @@ enum LayoutFlag {
 struct DenseParam : public dmlc::Parameter<DenseParam> {
   int units;
   bool use_bias;
+  int out_dtype;
 
   DMLC_DECLARE_PARAMETER(DenseParam) {
     DMLC_DECLARE_FIELD(units).set_lower_bound(1)
     .describe("Number of hidden units of the dense transformation.");
     DMLC_DECLARE_FIELD(use_bias).set_default(true)
     .describe("Whether to use bias parameter");
+    DMLC_DECLARE_DTYPE_FIELD(out_dtype)
+    .add_enum("same", -1)
+    .set_default(-1)
+    .describe("Output data type, set to explicit type under mixed precision setting");
   }
   // constants
   static const constexpr int kData = 0;
@@ -125,6 +131,7 @@ struct Conv2DParam : public dmlc::Parameter<Conv2DParam> {
   int groups;
   int layout;
   bool use_bias;
+  int out_dtype;
 
   DMLC_DECLARE_PARAMETER(Conv2DParam) {
     DMLC_DECLARE_FIELD(channels)
@@ -155,6 +162,10 @@ struct Conv2DParam : public dmlc::Parameter<Conv2DParam> {
                 "'W' dimensions.");
     DMLC_DECLARE_FIELD(use_bias).set_default(true)
       .describe("Whether the layer uses a bias vector.");
+    DMLC_DECLARE_DTYPE_FIELD(out_dtype)
+      .add_enum("same", -1)
+      .set_default(-1)
+      .describe("Output data type, set to explicit type under mixed precision setting");
   }
   // constants
   static const constexpr int kData = 0;
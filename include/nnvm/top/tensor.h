@@ -91,6 +91,21 @@ struct CastParam : public dmlc::Parameter<CastParam> {
   }
 };
 
+struct QuantizeParam : public dmlc::Parameter<QuantizeParam> {
+  double scale;
+  int out_dtype;
+  DMLC_DECLARE_PARAMETER(QuantizeParam) {
+    DMLC_DECLARE_FIELD(scale).set_default(1.0)
+    .describe("The real value represented by one quantization step.");
+    DMLC_DECLARE_FIELD(out_dtype)
+    .add_enum("int8",  kInt8)
+    .add_enum("int16", kInt16)
+    .add_enum("int32", kInt32)
+    .set_default(kInt8)
+    .describe("Output integer data type.");
+  }
+};
+
 struct IndicatorParam : public dmlc::Parameter<IndicatorParam> {
   TShape axis;
   bool exclude;
@@ -8,10 +8,14 @@ from __future__ import absolute_import
 
 import tvm
 
-from . import build_module
+from . import build_module, graph_executor
 from . build_module import build, optimize, build_config
 from . compile_engine import engine, graph_key
-from . param_dict import save_param_dict, load_param_dict
+from . param_dict import save_param_dict, load_param_dict, save_param_file, load_param_file
+from . quantization import calibrate, quantize
+from . bundle import save_bundle, load_bundle, load_bundle_section
+from . multi_batch import build_multi_batch, load_multi_batch
+from . profiler import profile_fused_ops, format_profile
 
 from .. import symbol as _symbol
 from .. import graph as _graph
@@ -5,8 +5,8 @@ from __future__ import absolute_import as _abs
 import logging
 import tvm
 
-from tvm.contrib import graph_runtime
-from . import graph_attr, graph_util
+from . import graph_attr, graph_util, graph_executor
+from .bundle import save_bundle
 from .. import graph as _graph
 from .. import symbol as sym
 from .._base import _all_var_init
@@ -15,7 +15,9 @@ OPT_PASS_LEVEL = {
     "SimplifyInference": 0,
     "PrecomputePrune": 2,
     "OpFusion": 1,
-    "FoldScaleAxis": 3
+    "FoldPad": 2,
+    "FoldScaleAxis": 3,
+    "AutoMixedPrecision": 4
 }
 
 # List of optimization pass and level when switch on
@@ -31,6 +33,9 @@ class BuildConfig(object):
     defaults = {
         "opt_level": 2,
         "add_pass": None,
+        "amp_allow_list": None,
+        "amp_deny_list": None,
+        "num_streams": 0,
     }
     def __init__(self, **kwargs):
         self._old_scope = None
@@ -89,6 +94,20 @@ def build_config(**kwargs):
     add_pass: set of str
         Optimization pass to be added regardless of optimization level.
 
+    amp_allow_list: list of str
+        Operators that AutoMixedPrecision always runs in float16.
+        Uses the default list of conv2d, conv2d_transpose, dense and matmul if None.
+
+    amp_deny_list: list of str
+        Operators that AutoMixedPrecision always runs in float32.
+        Uses the default list of reductions, softmax, exp and log if None.
+        Reductions of the COMM_REDUCE pattern run in float32 unless allowed.
+
+    num_streams: int, default=0
+        Number of streams of the inter-op parallel schedule saved in the graph,
+        see ParallelSchedule. The memory plan then keeps the buffers of
+        concurrent nodes apart. 0 for sequential execution.
+
     Returns
     -------
     config: BuildConfig
@@ -139,7 +158,35 @@ def _update_shape_dtype(shape, dtype, params):
     return shape, dtype
 
 
-def optimize(graph, shape, dtype="float32"):
+def _layout_shape(shape, layout):
+    """Convert a shape in the primal layout into the shape in layout,
+    i.e. (1, 32, 8, 8) into (1, 2, 8, 8, 16) for NCHW16c."""
+    primal = [c for c in layout if c.isupper()]
+    if len(primal) != len(shape):
+        raise ValueError("shape %s does not match layout %s" % (str(shape), layout))
+    factors = {}
+    ret = []
+    num = ""
+    for c in layout:
+        if c.isdigit():
+            num += c
+        elif c.islower():
+            factors[c.upper()] = int(num)
+            num = ""
+    for c in layout:
+        if c.isupper():
+            size = shape[primal.index(c)]
+            factor = factors.get(c, 1)
+            if size % factor != 0:
+                raise ValueError("axis %s of size %d cannot be blocked by %d" %
+                                 (c, size, factor))
+            ret.append(size // factor)
+        elif c.islower():
+            ret.append(factors[c.upper()])
+    return tuple(ret)
+
+
+def optimize(graph, shape, dtype="float32", layout=None):
     """Perform target and parameter invariant graph optimization.
 
     This is an advanced function that usually do not need to be called.
@@ -150,24 +197,51 @@ def optimize(graph, shape, dtype="float32"):
     graph : Graph
         The graph to be used in optimized.
 
+    shape : dict of str to tuple
+        The input shapes in the primal layout.
+
+    dtype : str or dict of str to str
+        The input types.
+
+    layout : dict of str to str, optional
+        The layouts of the inputs, the graph is transformed to run
+        the operators in the layouts that need the fewest transforms.
+
     Returns
     -------
     graph : Graph
         The optimized graph.
     """
-    # pylint: disable=unused-argument
+    # InferShape and InferType are applied by the passes that depend on them.
     cfg = BuildConfig.current
     if cfg.pass_enabled("SimplifyInference"):
         graph = graph_attr.set_shape_inputs(graph, shape)
-        graph = graph.apply(["InferShape", "SimplifyInference"])
+        graph = graph.apply("SimplifyInference")
+
+    if cfg.pass_enabled("FoldPad"):
+        graph = graph.apply(["FoldPad"])
 
     if cfg.pass_enabled("FoldScaleAxis"):
         graph = graph_attr.set_shape_inputs(graph, shape)
-        graph = graph.apply(["InferShape", "FoldScaleAxis"])
+        graph = graph.apply("FoldScaleAxis")
+
+    if cfg.pass_enabled("AutoMixedPrecision"):
+        if cfg.amp_allow_list is not None:
+            graph._set_json_attr("amp_allow_list", list(cfg.amp_allow_list), "list_str")
+        if cfg.amp_deny_list is not None:
+            graph._set_json_attr("amp_deny_list", list(cfg.amp_deny_list), "list_str")
+        graph = graph_attr.set_dtype_inputs(graph, dtype)
+        graph = graph.apply("AutoMixedPrecision")
+
+    if layout:
+        graph = graph_attr.set_shape_inputs(graph, shape)
+        graph = graph_attr.set_layout_inputs(graph, layout)
+        graph = graph.apply("LayoutTransform")
     return graph
 
 
-def build(graph, target=None, shape=None, dtype="float32", params=None, target_host=None):
+def build(graph, target=None, shape=None, dtype="float32", params=None, target_host=None,
+          bundle=None, layout=None):
     """Build graph into runtime library.
 
     The build function will optimize the graph and do the compilation.
@@ -207,6 +281,16 @@ def build(graph, target=None, shape=None, dtype="float32", params=None, target_h
     initialize : bool, optional
         Whether to initialize variables in global dict _all_var_init.
 
+    bundle : str, optional
+        Also save the result into a single file bundle at this path,
+        which can be loaded by :any:`load_bundle`.
+
+    layout : dict of str to str, optional
+        The layouts of the inputs that are not params, e.g. NCHW16c.
+        The shapes are given in the primal layout, the execution graph
+        takes these inputs in their layouts. The outputs are in the
+        primal layout.
+
     Returns
     -------
     graph : Graph
@@ -219,6 +303,20 @@ def build(graph, target=None, shape=None, dtype="float32", params=None, target_h
         The updated parameters of graph if params is passed.
         This can be different from the params passed in.
     """
+    graph, libmod, params = _build_graph(
+        graph, target, shape, dtype, params, target_host, layout)
+    if bundle:
+        save_bundle(bundle, graph, libmod, params)
+    return graph, libmod, params
+
+
+def _build_graph(graph, target, shape, dtype, params, target_host, layout,
+                 lower_only=False):
+    """Build the graph, see :any:`build`.
+
+    When lower_only is set, the lowered functions of the execution graph
+    are returned instead of the module, to be built into a module later.
+    """
     target = target if target else tvm.target.current_target()
     if target is None:
         raise ValueError("Target is not set in env or passed as argument.")
@@ -241,10 +339,17 @@ def build(graph, target=None, shape=None, dtype="float32", params=None, target_h
     if _all_var_init:
         init_var = initialize_variables(shape, dtype)
     # Apply optimization
-    graph = optimize(graph, shape, dtype)
+    graph = optimize(graph, shape, dtype, layout)
+    if layout:
+        for k, v in layout.items():
+            if v != "default":
+                shape[k] = _layout_shape(shape[k], v)
     # Precompute prune
     if params and cfg.pass_enabled("PrecomputePrune"):
         graph, params = precompute_prune(graph, params)
+        if isinstance(dtype, str):
+            # pre-computed params can have other types, e.g. quantized weights.
+            dtype = {k : dtype for k in shape}
         shape, dtype = _update_shape_dtype(shape, dtype, params)
     # Operator Fusion and generation
     graph = graph_attr.set_shape_inputs(graph, shape)
@@ -256,10 +361,16 @@ def build(graph, target=None, shape=None, dtype="float32", params=None, target_h
         graph._set_json_attr("opt_level", 1, "int")
     else:
         graph._set_json_attr("opt_level", 0, "int")
-    graph = graph.apply("InferShape").apply("InferType")
+    if cfg.num_streams > 0:
+        graph._set_json_attr("num_streams", cfg.num_streams, "int")
+    if lower_only:
+        graph._set_json_attr("lower_only", 1, "int")
     with target:
         graph = graph.apply("GraphFusePartition").apply("GraphFuseCompile")
-    libmod = graph_attr._move_out_module(graph, "module")
+    if lower_only:
+        libmod = graph_attr._move_out_lowered_funcs(graph, "lowered_funcs")
+    else:
+        libmod = graph_attr._move_out_module(graph, "module")
     # Write variable initial values into params
     if init_var:
         if params is None:
@@ -292,7 +403,7 @@ def _run_graph(graph, params):
     _, oshape = graph_util.infer_shape(graph, **shape)
     _, odtype = graph_util.infer_dtype(graph, **dtype)
     graph, libmod, _ = build(graph, target, shape, dtype)
-    m = graph_runtime.create(graph, libmod, ctx)
+    m = graph_executor.create(graph, libmod, ctx)
     set_input, run, get_output = m["set_input"], m["run"], m["get_output"]
     kset = set(graph.symbol.list_input_names())
     for k, v in params.items():
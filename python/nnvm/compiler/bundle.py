@@ -0,0 +1,118 @@
+# pylint: disable=invalid-name, protected-access
+"""Single file bundle of a compiled model.
+
+The bundle holds the execution graph, the parameters in the aligned
+format of :any:`save_param_file` and the path of the module library,
+which is exported next to the bundle. Loading a bundle maps the file
+once, the parameters point into the mapping.
+"""
+from __future__ import absolute_import as _abs
+
+import os
+import tvm
+from . import param_dict as _param_dict
+from .. import graph as _graph
+
+_save_bundle = tvm.get_global_func("nnvm.compiler._save_bundle")
+_load_bundle = tvm.get_global_func("nnvm.compiler._load_bundle")
+
+
+def save_bundle(path, graph, lib, params, codec=None, sections=None):
+    """Save the result of :any:`build` into a bundle.
+
+    Parameters
+    ----------
+    path : str
+        The path to the bundle. The module library is
+        exported to path + ".so".
+
+    graph : Graph or str
+        The execution graph or its json.
+
+    lib : tvm.Module
+        The module that comes with the execution graph.
+
+    params : dict of str to NDArray
+        The parameters of the graph.
+
+    codec : str or dict of str to str, optional
+        The storage codec of the parameters, see :any:`save_param_file`.
+
+    sections : dict of str to str, optional
+        Extra sections of text, read back by :any:`load_bundle_section`.
+    """
+    graph_json = graph.json() if isinstance(graph, _graph.Graph) else graph
+    lib_path = path + ".so"
+    lib.export_library(lib_path)
+    sections = sections if sections else {}
+    args = [path, graph_json, os.path.basename(lib_path), len(sections)]
+    for k, v in sorted(sections.items()):
+        args += [k, v]
+    args += _param_dict._param_file_args(params if params else {}, codec)
+    _save_bundle(*args)
+
+
+def load_bundle(path, sections=None):
+    """Load a bundle saved by :any:`save_bundle`.
+
+    Parameters
+    ----------
+    path : str
+        The path to the bundle.
+
+    sections : list of str, optional
+        The names of extra sections to read from the same mapping.
+
+    Returns
+    -------
+    graph_json : str
+        The json of the execution graph.
+
+    lib : tvm.Module
+        The module that comes with the execution graph.
+
+    params : dict of str to NDArray
+        The parameters, cpu arrays pointing into the mapping of the bundle.
+
+    texts : dict of str to str
+        Only returned when sections is given, the text of each section,
+        None if the bundle does not have it.
+
+    Examples
+    --------
+    .. code-block:: python
+
+       graph_json, lib, params = nnvm.compiler.load_bundle("deploy.bundle")
+       module = graph_runtime.create(graph_json, lib, tvm.cpu(0))
+       module.set_input(**params)
+    """
+    load_mod = _load_bundle(path)
+    lib_path = os.path.join(os.path.dirname(os.path.abspath(path)), load_mod(4))
+    lib = tvm.module.load(lib_path)
+    params = _param_dict._to_param_dict(load_mod, mapped=True)
+    if sections is None:
+        return load_mod(3), lib, params
+    texts = {name: load_mod(5, name) or None for name in sections}
+    return load_mod(3), lib, params, texts
+
+
+def load_bundle_section(path, name):
+    """Load an extra section saved by :any:`save_bundle`.
+    The bundle is mapped again, use the sections argument of
+    :any:`load_bundle` to read the sections together with the model.
+
+    Parameters
+    ----------
+    path : str
+        The path to the bundle.
+
+    name : str
+        The name of the section.
+
+    Returns
+    -------
+    text : str
+        The text of the section, None if the bundle does not have it.
+    """
+    text = _load_bundle(path)(5, name)
+    return text if text else None
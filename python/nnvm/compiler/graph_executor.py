@@ -0,0 +1,138 @@
+# pylint: disable=invalid-name
+"""Multithreaded executor of the compiled graph.
+
+The executor allocates the storage of the memory plan once. When the
+graph is built with ``num_streams`` in :any:`build_config`, the
+independent nodes of each level of the schedule run on a work
+stealing thread pool.
+"""
+from __future__ import absolute_import as _abs
+
+import tvm
+from .. import graph as _graph
+
+_create_executor = tvm.get_global_func("nnvm.compiler._create_executor")
+
+
+def create(graph, lib, ctx=None, num_threads=0):
+    """Create an executor of a compiled graph.
+
+    Parameters
+    ----------
+    graph : Graph or str
+        The execution graph returned by :any:`build`, or its json.
+
+    lib : tvm.Module
+        The module returned by :any:`build`.
+
+    ctx : TVMContext, optional
+        The context to run on, cpu by default.
+
+    num_threads : int, optional
+        The number of threads running a level of the schedule,
+        0 for the number of cores. The nodes run in order on the
+        caller when it is 1 or the graph has no schedule.
+
+    Returns
+    -------
+    executor : GraphExecutor
+        The executor.
+    """
+    graph = graph if isinstance(graph, _graph.Graph) else _graph.load_json(graph)
+    ctx = ctx if ctx is not None else tvm.cpu(0)
+    module = _create_executor(graph.json(), lib, ctx.device_type,
+                              ctx.device_id, num_threads)
+    return GraphExecutor(module, graph, ctx)
+
+
+class GraphExecutor(object):
+    """Wrapper of the executor module.
+
+    Parameters
+    ----------
+    module : tvm.Module
+        The executor module.
+
+    graph : Graph
+        The execution graph.
+
+    ctx : TVMContext
+        The context of the executor.
+    """
+    def __init__(self, module, graph, ctx):
+        self.module = module
+        self.ctx = ctx
+        self._set_input = module["set_input"]
+        self._run = module["run"]
+        self._get_output = module["get_output"]
+        index = graph.index
+        shapes = graph.json_attr("shape")
+        dltypes = graph.json_attr("dltype")
+        self._output_info = []
+        for entry in index.output_entries:
+            eid = index.entry_id(entry)
+            self._output_info.append((shapes[eid], dltypes[eid]))
+
+    def set_input(self, key=None, value=None, **params):
+        """Set the inputs.
+
+        Parameters
+        ----------
+        key : int or str
+            The index or name of the input.
+
+        value : array_like
+            The value of the input.
+
+        params : dict of str to array_like
+            Additional inputs.
+        """
+        if key is not None:
+            self._set_input(key, self._array(value))
+        for k, v in params.items():
+            self._set_input(k, self._array(v))
+
+    def _array(self, value):
+        return value if isinstance(value, tvm.nd.NDArray) else tvm.nd.array(value, self.ctx)
+
+    def run(self, **inputs):
+        """Run the graph.
+
+        Parameters
+        ----------
+        inputs : dict of str to array_like
+            The inputs to set before the run.
+        """
+        if inputs:
+            self.set_input(**inputs)
+        self._run()
+
+    @property
+    def num_outputs(self):
+        """Number of outputs of the graph."""
+        return len(self._output_info)
+
+    def get_output(self, index, out=None):
+        """Get an output.
+
+        Parameters
+        ----------
+        index : int
+            The index of the output.
+
+        out : tvm.NDArray, optional
+            The array to copy the output into.
+
+        Returns
+        -------
+        out : tvm.NDArray
+            The output.
+        """
+        if out is None:
+            shape, dtype = self._output_info[index]
+            out = tvm.nd.empty(shape, dtype, self.ctx)
+        self._get_output(index, out)
+        return out
+
+    def __getitem__(self, key):
+        return self.module[key]
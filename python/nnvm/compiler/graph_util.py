@@ -66,6 +66,48 @@ def infer_dtype(graph, **dtype):
     return input_dtype, output_dtype
 
 
+def estimate_cost(graph, shape, dtype="float32"):
+    """Estimate the floating point operations and memory traffic of a graph.
+
+    Parameters
+    ----------
+    graph : Graph
+        The graph to be estimated.
+
+    shape : dict of str to tuple
+        The input shapes.
+
+    dtype : str or dict of str to str, optional
+        The input types.
+
+    Returns
+    -------
+    cost : dict
+        The "flop", "bytes_read" and "bytes_written" of the whole graph,
+        its "arithmetic_intensity" in flop per byte, and "nodes", the
+        list of (name, op, flop, bytes_read, bytes_written) of each operator.
+    """
+    graph = graph_attr.set_shape_inputs(graph, shape)
+    graph = graph_attr.set_dtype_inputs(graph, dtype)
+    graph = graph.apply(["InferShape", "InferType", "EstimateCost"])
+    flop = graph.json_attr("flop")
+    bytes_read = graph.json_attr("bytes_read")
+    bytes_written = graph.json_attr("bytes_written")
+    nodes = []
+    for nid, node in enumerate(graph.index.nodes):
+        if node["op"] == "null":
+            continue
+        nodes.append((node["name"], node["op"], flop[nid],
+                      bytes_read[nid], bytes_written[nid]))
+    total_flop = sum(n[2] for n in nodes)
+    total_bytes = sum(n[3] + n[4] for n in nodes)
+    return {"flop": total_flop,
+            "bytes_read": sum(n[3] for n in nodes),
+            "bytes_written": sum(n[4] for n in nodes),
+            "arithmetic_intensity": float(total_flop) / total_bytes if total_bytes else 0.0,
+            "nodes": nodes}
+
+
 _deep_compare = tvm.get_global_func("nnvm.graph.DeepCompare")
 
 def check_graph_equal(grapha, graphb, compare_variable_attrs=False):
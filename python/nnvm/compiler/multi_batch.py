@@ -0,0 +1,295 @@
+# pylint: disable=invalid-name, protected-access
+"""Variants of a compiled model for several batch sizes.
+
+:any:`build_multi_batch` builds the model once per batch size. The
+kernels that do not depend on the batch size come from the compile
+engine cache. Each variant is only lowered, and the lowered functions of
+all the variants are built once into one module, so the variants share
+the module and the parameters.
+The dispatcher runs a batch on the smallest variant that fits, padding
+the batch, and splits a batch larger than every variant. This assumes
+the rows of a batch are independent. A model with outputs without the
+batch dimension, e.g. reduced over the batch, only runs batches of the
+variant sizes.
+"""
+from __future__ import absolute_import as _abs
+
+import json
+import numpy as np
+import tvm
+from . import build_module, graph_executor
+from .bundle import save_bundle, load_bundle
+from .. import graph as _graph
+
+_SECTION = "batch_variants"
+
+
+def build_multi_batch(graph, target, shape, batch_sizes, dtype="float32",
+                      params=None, target_host=None, batch_axis=0):
+    """Build the variants of a graph for several batch sizes.
+
+    Parameters
+    ----------
+    graph : Symbol or Graph
+        The graph to be used in the compilation.
+
+    target : str or :any:`tvm.target.Target`
+        The build target.
+
+    shape : dict of str to tuple
+        The shapes of the batched inputs, the batch dimension
+        is replaced by each of the batch sizes.
+
+    batch_sizes : list of int
+        The batch sizes of the variants.
+
+    dtype : str or dict of str to str
+        The input types of the graph.
+
+    params : dict of str to NDArray
+        The parameters, shared by the variants.
+
+    target_host : str or :any:`tvm.target.Target`, optional
+        The host compilation target, see :any:`build`.
+
+    batch_axis : int, optional
+        The batch dimension of the batched inputs and outputs.
+
+    Returns
+    -------
+    model : MultiBatchModel
+        The variants of the model.
+    """
+    batch_sizes = sorted(set(int(x) for x in batch_sizes))
+    if not batch_sizes or batch_sizes[0] <= 0:
+        raise ValueError("require positive batch sizes")
+    graphs = {}
+    shared_params = None
+    funcs = {}
+    for batch_size in batch_sizes:
+        vshape = {}
+        for k, v in shape.items():
+            v = list(v)
+            v[batch_axis] = batch_size
+            vshape[k] = tuple(v)
+        vparams = dict(params) if params else None
+        vgraph, vfuncs, vparams = build_module._build_graph(
+            graph, target, vshape, dtype, vparams, target_host, None, lower_only=True)
+        # the functions of the execution graph, shared kernels are built once.
+        for f in vfuncs:
+            funcs.setdefault(f.name, f)
+        for node in vgraph.index.nodes:
+            name = node.get("attrs", {}).get("func_name")
+            if node["op"] == "tvm_op" and name != "__nop" and name not in funcs:
+                raise ValueError("function %s of batch size %d is not lowered" %
+                                 (name, batch_size))
+        graphs[batch_size] = vgraph
+        vparams = vparams if vparams else {}
+        if shared_params is None:
+            shared_params = vparams
+        elif set(vparams) != set(shared_params):
+            raise ValueError("the parameters depend on the batch size")
+    lib = tvm.build(list(funcs.values()), target=target, target_host=target_host)
+    return MultiBatchModel(graphs, lib, shared_params, list(shape), batch_axis)
+
+
+def load_multi_batch(path):
+    """Load the variants saved by :any:`MultiBatchModel.save`.
+
+    Parameters
+    ----------
+    path : str
+        The path to the bundle.
+
+    Returns
+    -------
+    model : MultiBatchModel
+        The variants of the model.
+    """
+    graph_json, lib, params, texts = load_bundle(path, sections=[_SECTION])
+    text = texts[_SECTION]
+    if text is None:
+        raise ValueError("%s is not a multi batch bundle" % path)
+    info = json.loads(text)
+    graphs = {int(k): _graph.load_json(v) for k, v in info["graphs"].items()}
+    graphs[max(info["batch_sizes"])] = _graph.load_json(graph_json)
+    return MultiBatchModel(graphs, lib, params, info["batch_inputs"], info["batch_axis"])
+
+
+class MultiBatchModel(object):
+    """The variants of a model for several batch sizes.
+
+    Parameters
+    ----------
+    graphs : dict of int to Graph
+        The execution graph of each batch size.
+
+    lib : tvm.Module
+        The module shared by the variants.
+
+    params : dict of str to NDArray
+        The parameters shared by the variants.
+
+    batch_inputs : list of str
+        The names of the batched inputs.
+
+    batch_axis : int
+        The batch dimension of the batched inputs and outputs.
+    """
+    def __init__(self, graphs, lib, params, batch_inputs, batch_axis):
+        self.graphs = graphs
+        self.lib = lib
+        self.params = params
+        self.batch_inputs = batch_inputs
+        self.batch_axis = batch_axis
+
+    @property
+    def batch_sizes(self):
+        """The sorted batch sizes of the variants."""
+        return sorted(self.graphs)
+
+    def save(self, path, codec=None):
+        """Save the variants into a single file bundle.
+
+        The largest variant is the graph of the bundle, so the
+        bundle also loads as a single model by :any:`load_bundle`.
+
+        Parameters
+        ----------
+        path : str
+            The path to the bundle, the module library is
+            exported to path + ".so".
+
+        codec : str or dict of str to str, optional
+            The storage codec of the parameters, see :any:`save_param_file`.
+        """
+        largest = self.batch_sizes[-1]
+        info = {
+            "batch_sizes": self.batch_sizes,
+            "batch_inputs": self.batch_inputs,
+            "batch_axis": self.batch_axis,
+            "graphs": {str(k): g.json() for k, g in self.graphs.items() if k != largest},
+        }
+        save_bundle(path, self.graphs[largest], self.lib, self.params, codec,
+                    sections={_SECTION: json.dumps(info)})
+
+    def dispatcher(self, ctx=None, num_threads=0):
+        """Create the executors of the variants.
+
+        Parameters
+        ----------
+        ctx : TVMContext, optional
+            The context to run on, cpu by default.
+
+        num_threads : int, optional
+            The number of threads of each executor, see :any:`graph_executor.create`.
+
+        Returns
+        -------
+        dispatcher : BatchDispatcher
+            The dispatcher.
+        """
+        return BatchDispatcher(self, ctx, num_threads)
+
+
+class BatchDispatcher(object):
+    """Run a batch of any size on the variants of a model.
+
+    Parameters
+    ----------
+    model : MultiBatchModel
+        The variants of the model.
+
+    ctx : TVMContext, optional
+        The context to run on, cpu by default.
+
+    num_threads : int, optional
+        The number of threads of each executor.
+    """
+    def __init__(self, model, ctx=None, num_threads=0):
+        self.model = model
+        self.batch_sizes = model.batch_sizes
+        self._executors = {}
+        axis = model.batch_axis
+        oshapes = {}
+        for batch_size in self.batch_sizes:
+            graph = model.graphs[batch_size]
+            m = graph_executor.create(graph, model.lib, ctx, num_threads)
+            if model.params:
+                m.set_input(**model.params)
+            self._executors[batch_size] = m
+            shapes = graph.json_attr("shape")
+            index = graph.index
+            oshapes[batch_size] = [tuple(shapes[index.entry_id(e)])
+                                   for e in index.output_entries]
+        # an output is batched when its batch dimension follows the batch
+        # size in every variant, and not batched when its shape is fixed.
+        self._batched_outputs = []
+        first = oshapes[self.batch_sizes[0]]
+        for i in range(len(first)):
+            if all(len(oshapes[b][i]) > axis and oshapes[b][i][axis] == b
+                   for b in self.batch_sizes):
+                self._batched_outputs.append(True)
+            elif all(oshapes[b][i] == first[i] for b in self.batch_sizes):
+                self._batched_outputs.append(False)
+            else:
+                raise ValueError("the shape of output %d does not follow the batch size" % i)
+
+    def select(self, batch_size):
+        """The smallest batch size of the variants not less than batch_size,
+        the largest batch size if none of the variants fits."""
+        for x in self.batch_sizes:
+            if x >= batch_size:
+                return x
+        return self.batch_sizes[-1]
+
+    def run(self, **inputs):
+        """Run a batch.
+
+        Parameters
+        ----------
+        inputs : dict of str to numpy.ndarray
+            The inputs. The batched inputs have the same batch size.
+
+        Returns
+        -------
+        outputs : list of numpy.ndarray
+            The outputs, the batched ones are cut to the batch size.
+        """
+        axis = self.model.batch_axis
+        batch_inputs = [k for k in self.model.batch_inputs if k in inputs]
+        if not batch_inputs:
+            raise ValueError("require the batched inputs %s" % self.model.batch_inputs)
+        total = inputs[batch_inputs[0]].shape[axis]
+        if not all(self._batched_outputs) and self.select(total) != total:
+            # e.g. a reduction over the batch would include the padding,
+            # or only cover the first chunk.
+            raise ValueError("the model has outputs without the batch dimension, "
+                             "a batch of size %d cannot be padded or split" % total)
+        chunks = []
+        begin = 0
+        while begin < total:
+            size = min(total - begin, self.batch_sizes[-1])
+            variant = self.select(size)
+            feed = dict(inputs)
+            for k in batch_inputs:
+                data = np.take(inputs[k], range(begin, begin + size), axis=axis)
+                if variant > size:
+                    pad = [(0, 0)] * data.ndim
+                    pad[axis] = (0, variant - size)
+                    data = np.pad(data, pad, "constant")
+                feed[k] = data
+            m = self._executors[variant]
+            m.run(**feed)
+            outputs = []
+            for i, batched in enumerate(self._batched_outputs):
+                out = m.get_output(i).asnumpy()
+                if batched:
+                    out = np.take(out, range(size), axis=axis)
+                outputs.append(out)
+            chunks.append(outputs)
+            begin += size
+        if len(chunks) == 1:
+            return chunks[0]
+        return [np.concatenate([c[i] for c in chunks], axis=axis)
+                for i in range(len(self._batched_outputs))]
@@ -6,6 +6,10 @@ from tvm._ffi.runtime_ctypes import TVMArrayHandle
 
 _save_param_dict = tvm.get_global_func("nnvm.compiler._save_param_dict")
 _load_param_dict = tvm.get_global_func("nnvm.compiler._load_param_dict")
+_save_param_file = tvm.get_global_func("nnvm.compiler._save_param_file")
+_load_param_file = tvm.get_global_func("nnvm.compiler._load_param_file")
+_load_param_file_stream = tvm.get_global_func("nnvm.compiler._load_param_file_stream")
+_load_param_file_into = tvm.get_global_func("nnvm.compiler._load_param_file_into")
 
 def save_param_dict(params):
     """Save parameter dictionary to binary bytes.
@@ -50,7 +54,8 @@ def load_param_dict(param_bytes):
     Parameters
     ----------
     param_bytes: bytearray
-        Serialized parameters.
+        Serialized parameters, by :any:`save_param_dict`
+        or the content of a file saved by :any:`save_param_file`.
 
     Returns
     -------
@@ -60,10 +65,127 @@ def load_param_dict(param_bytes):
     if isinstance(param_bytes, (bytes, str)):
         param_bytes = bytearray(param_bytes)
     load_mod = _load_param_dict(param_bytes)
-    size = load_mod(0)
+    return _to_param_dict(load_mod)
+
+
+class _MappedNDArray(tvm.nd.NDArray):
+    """Array pointing into a mapped file.
+
+    The array holds the loader function, which owns the mapping,
+    so the mapping is released after the last of its arrays.
+    """
+    def __init__(self, handle, load_mod):
+        super(_MappedNDArray, self).__init__(handle, True)
+        self._load_mod = load_mod
+
+
+# storage codec of the parameter file
+_PARAM_CODEC = {"raw": 0, "float16": 1}
+
+
+def save_param_file(params, path, codec=None):
+    """Save parameter dictionary to file in the aligned format.
+
+    Every tensor is stored at a page aligned offset recorded in
+    the header of the file, so the file can be memory mapped by
+    :any:`load_param_file` without copying the tensors.
+    Tensors with identical content, e.g. tied weights,
+    are stored only once.
+
+    Parameters
+    ----------
+    params : dict of str to NDArray
+        The parameter dictionary.
+
+    path : str
+        The path to the file.
+
+    codec : str or dict of str to str, optional
+        The storage codec, "raw" or "float16". "float16" stores float32
+        tensors in half precision, which are upcast to float32 on load.
+        A str applies to all float32 tensors, a dict selects the codec
+        of each tensor by name.
+    """
+    _save_param_file(*([path] + _param_file_args(params, codec)))
+
+
+def _param_file_args(params, codec):
+    """Get the name, array and codec of each parameter."""
+    args = []
+    for k, v in params.items():
+        v = tvm.nd.array(v)
+        if isinstance(codec, dict):
+            c = codec.get(k, "raw")
+        else:
+            c = codec if codec and v.dtype == "float32" else "raw"
+        if c not in _PARAM_CODEC:
+            raise ValueError("unknown param codec %s" % c)
+        args.append(k)
+        args.append(v)
+        args.append(_PARAM_CODEC[c])
+    return args
+
+
+def _to_param_dict(load_mod, mapped=False):
     param_dict = {}
+    size = load_mod(0)
     for i in range(size):
         key = load_mod(1, i)
         dltensor_handle = ctypes.cast(load_mod(2, i), TVMArrayHandle)
-        param_dict[key] = tvm.nd.NDArray(dltensor_handle, False)
+        if mapped:
+            param_dict[key] = _MappedNDArray(dltensor_handle, load_mod)
+        else:
+            param_dict[key] = tvm.nd.NDArray(dltensor_handle, False)
     return param_dict
+
+
+def load_param_file(path, mmap=True, out=None, nthread=1):
+    """Load parameter dictionary from file.
+
+    Parameters
+    ----------
+    path : str
+        The path to the file.
+
+    mmap : bool, optional
+        Whether to return cpu arrays pointing into a private mapping
+        of the file. The pages are only read when they are accessed.
+        Tensors stored once share the memory of the mapping, tensors
+        stored in float16 are decoded into new memory. The mapping is
+        released after the last of the arrays.
+        Otherwise the arrays are read from the file one by one, without
+        buffering the whole file. The file can also be in the format of
+        :any:`save_param_dict` when it is not mapped.
+
+    out : dict of str to NDArray, optional
+        Read the parameters into these arrays instead, e.g. the inputs
+        of a module. The arrays must match the shape and type in the file.
+
+    nthread : int, optional
+        The number of threads reading the file when it is not mapped.
+        Large tensors are split into shards read in parallel.
+
+    Returns
+    -------
+    params : dict of str to NDArray
+        The parameter dictionary, which is out when it is given.
+
+    Examples
+    --------
+    .. code-block:: python
+
+       nnvm.compiler.save_param_file(params, "deploy.params")
+       # set_input copies from the mapping into the module.
+       module.set_input(**nnvm.compiler.load_param_file("deploy.params"))
+    """
+    if out is not None:
+        args = [path, nthread]
+        for k, v in out.items():
+            args.append(k)
+            args.append(v)
+        _load_param_file_into(*args)
+        return out
+    if not mmap:
+        return _to_param_dict(_load_param_file_stream(path, nthread))
+    load_mod = _load_param_file(path)
+    return _to_param_dict(load_mod, mapped=True)
@@ -0,0 +1,96 @@
+# pylint: disable=invalid-name
+"""Profile the fused operators of a compiled graph.
+
+Each tvm_op node produced by GraphFuseCompile records the names of
+the source nodes fused into it and an estimate of its floating point
+operations, which maps the kernel times back to the layers of the
+original model.
+"""
+from __future__ import absolute_import as _abs
+
+import numpy as np
+import tvm
+from .. import graph as _graph
+
+
+def profile_fused_ops(graph, lib, ctx=None, number=10):
+    """Time each fused kernel of a compiled graph on random inputs.
+
+    Parameters
+    ----------
+    graph : Graph
+        The execution graph returned by :any:`build`.
+
+    lib : tvm.Module
+        The module returned by :any:`build`.
+
+    ctx : TVMContext, optional
+        The context to run the kernels on, cpu by default.
+
+    number : int, optional
+        The number of runs averaged for each kernel.
+
+    Returns
+    -------
+    profile : list of dict
+        The record of each fused op, in execution order, with keys
+        "name", "func_name", "fused_nodes", "flop", "time_ms" and "gflops".
+    """
+    graph = graph if isinstance(graph, _graph.Graph) else _graph.load_json(graph)
+    ctx = ctx if ctx is not None else tvm.cpu(0)
+    index = graph.index
+    shapes = graph.json_attr("shape")
+    dltypes = graph.json_attr("dltype")
+
+    def _array(eid, flatten):
+        shape = shapes[eid]
+        if flatten:
+            shape = [int(np.prod(shape))]
+        data = np.random.uniform(size=shape).astype(dltypes[eid])
+        return tvm.nd.array(data, ctx)
+
+    profile = []
+    for nid, node in enumerate(index.nodes):
+        if node["op"] != "tvm_op":
+            continue
+        attrs = node["attrs"]
+        func_name = attrs["func_name"]
+        if func_name.startswith("__"):
+            continue
+        flatten = int(attrs.get("flatten_data", "0")) != 0
+        args = [_array(index.entry_id(e), flatten) for e in node["inputs"]]
+        num_outputs = int(attrs.get("num_outputs", "1"))
+        args += [_array(index.entry_id(nid, i), flatten) for i in range(num_outputs)]
+        ftimer = lib.time_evaluator(func_name, ctx, number=number)
+        time_ms = ftimer(*args).mean * 1000
+        flop = int(attrs.get("flop", "0"))
+        fused_nodes = attrs.get("fused_nodes", "")
+        profile.append({
+            "name": node["name"],
+            "func_name": func_name,
+            "fused_nodes": fused_nodes.split(",") if fused_nodes else [],
+            "flop": flop,
+            "time_ms": time_ms,
+            "gflops": flop / time_ms / 1e6 if time_ms > 0 else 0.0})
+    return profile
+
+
+def format_profile(profile):
+    """Format the result of :any:`profile_fused_ops` as a table.
+
+    Parameters
+    ----------
+    profile : list of dict
+        The records of the fused ops.
+
+    Returns
+    -------
+    table : str
+        One line per fused op, with the total time at the end.
+    """
+    lines = ["%-32s %10s %10s  %s" % ("name", "time(ms)", "GFLOP/s", "fused nodes")]
+    for p in profile:
+        lines.append("%-32s %10.4f %10.2f  %s" % (
+            p["name"], p["time_ms"], p["gflops"], ",".join(p["fused_nodes"])))
+    lines.append("total %.4f ms" % sum(p["time_ms"] for p in profile))
+    return "\n".join(lines)
@@ -125,6 +125,43 @@ class Graph(object):
             return json.loads(json_str)[1]
         return None
 
+    def _bytes_attr(self, key):
+        """Get the raw bytes of a string attribute.
+
+        Parameters
+        ----------
+        key : str
+            The key to get attribute from.
+
+        Returns
+        -------
+        value : bytes
+            The attribute value of the key, returns None if attribute do not exist.
+        """
+        data = ctypes.c_void_p()
+        size = nn_uint()
+        success = ctypes.c_int()
+        check_call(_LIB.NNGraphGetBytesAttr(
+            self.handle, c_str(key), ctypes.byref(data),
+            ctypes.byref(size), ctypes.byref(success)))
+        if success.value != 0:
+            return ctypes.string_at(data, size.value)
+        return None
+
+    def _set_bytes_attr(self, key, value):
+        """Set a string attribute from raw bytes.
+
+        Parameters
+        ----------
+        key : string
+            The key of the attribute
+        value : bytes
+            The value of the attribute
+        """
+        value = bytes(value)
+        check_call(_LIB.NNGraphSetBytesAttr(
+            self.handle, c_str(key), value, nn_uint(len(value))))
+
     def _set_symbol_list_attr(self, key, value):
         """Set the attribute of the graph.
 
@@ -184,6 +221,19 @@ class Graph(object):
         """
         return self.apply("SaveJSON").json_attr("json")
 
+    def binary(self):
+        """Get the compact binary representation of the graph.
+
+        The binary form holds the same content as :any:`json`,
+        and is faster to save and load for large graphs.
+
+        Returns
+        -------
+        binary : bytes
+            Binary representation of the graph
+        """
+        return self.apply("SaveBinary")._bytes_attr("binary")
+
     def _tvm_graph_json(self):
         """Get TVM graph json"""
         return self.json()
@@ -213,7 +263,7 @@ class Graph(object):
             self._set_json_attr("join_node_attrs", join_node_attrs, "list_str")
         return self.apply("PrintGraphIR").json_attr("graphir")
 
-    def apply(self, passes):
+    def apply(self, passes, profile=False):
         """Apply passes to the graph
 
         Parameters
@@ -221,6 +271,12 @@ class Graph(object):
         passes : str or list of str
             The passes to be applied
 
+        profile : bool, optional
+            Whether to record the wall time, the node and entry counts
+            and the heap bytes allocated by each pass, including the
+            passes applied for dependencies and the phases inside passes.
+            The records are in ``g.json_attr("pass_profile")``.
+
         Returns
         -------
         g : Graph
@@ -231,7 +287,8 @@ class Graph(object):
         cpass = c_array(ctypes.c_char_p, [c_str(key) for key in passes])
         ghandle = GraphHandle()
         npass = nn_uint(len(passes))
-        check_call(_LIB.NNGraphApplyPasses(self.handle, npass, cpass, ctypes.byref(ghandle)))
+        fapply = _LIB.NNGraphApplyPassesProfile if profile else _LIB.NNGraphApplyPasses
+        check_call(fapply(self.handle, npass, cpass, ctypes.byref(ghandle)))
         return Graph(ghandle)
 
 
@@ -253,6 +310,24 @@ def load_json(json_str):
     return ret.apply("LoadJSON")
 
 
+def load_binary(data):
+    """Create a new graph by loading from binary form
+
+    Parameters
+    ----------
+    data : bytes
+        The bytes returned by Graph.binary
+
+    Returns
+    -------
+    graph : Graph
+        The loaded graph
+    """
+    ret = create(Variable("x"))
+    ret._set_bytes_attr("binary", data)
+    return ret.apply("LoadBinary")
+
+
 def create(symbol):
     """Create a new graph from symbol.
 
@@ -49,13 +49,34 @@ def schedule_log_softmax(_, outs, target):
 reg.register_pattern("log_softmax", OpPattern.OPAQUE)
 
 
+def _out_dtype(attrs, inputs):
+    """The accumulation type, e.g. int32 for int8 operands"""
+    out_dtype = attrs["out_dtype"]
+    return inputs[0].dtype if out_dtype == "same" else out_dtype
+
+
 # dense
 @reg.register_compute("dense")
 def compute_dense(attrs, inputs, _):
     """Compute definition of dense"""
+    out_dtype = _out_dtype(attrs, inputs)
+    if out_dtype == inputs[0].dtype:
+        if attrs.get_bool("use_bias"):
+            return topi.nn.dense(inputs[0], inputs[1], bias=inputs[2])
+        return topi.nn.dense(inputs[0], inputs[1])
+    # the operands are read in their type and widened in the reduction.
+    data, weight = inputs[0], inputs[1]
+    batch, in_dim = data.shape
+    out_dim, _ = weight.shape
+    k = tvm.reduce_axis((0, in_dim), name="k")
+    out = tvm.compute((batch, out_dim), lambda i, j: tvm.sum(
+        data[i, k].astype(out_dtype) * weight[j, k].astype(out_dtype), axis=k),
+                      tag="dense")
     if attrs.get_bool("use_bias"):
-        return topi.nn.dense(inputs[0], inputs[1], bias=inputs[2])
-    return topi.nn.dense(inputs[0], inputs[1])
+        bias = inputs[2]
+        out = tvm.compute((batch, out_dim), lambda i, j: out[i, j] + bias[j],
+                          tag=topi.tag.BROADCAST)
+    return out
 
 @reg.register_schedule("dense")
 def schedule_dense(_, outs, target):
@@ -78,10 +99,13 @@ def compute_conv2d(attrs, inputs, _):
     layout = attrs["layout"]
     assert layout == "NCHW" or layout == "NHWC"
     assert dilation == (1, 1), "not support dilate now"
+    out_dtype = _out_dtype(attrs, inputs)
     if groups == 1:
-        out = topi.nn.conv2d(inputs[0], inputs[1], strides, padding, layout)
+        out = topi.nn.conv2d(inputs[0], inputs[1], strides, padding, layout,
+                             out_dtype=out_dtype)
     elif groups == get_const_int(inputs[0].shape[1]) and groups == channels:
-        out = topi.nn.depthwise_conv2d_nchw(inputs[0], inputs[1], strides, padding)
+        out = topi.nn.depthwise_conv2d_nchw(inputs[0], inputs[1], strides, padding,
+                                            out_dtype=out_dtype)
     else:
         raise ValueError("not support arbitrary group number for now")
     if attrs.get_bool("use_bias"):
@@ -148,6 +148,14 @@ reg.register_schedule("broadcast_to", _fschedule_broadcast)
 reg.register_pattern("clip", OpPattern.ELEMWISE)
 reg.register_schedule("clip", _fschedule_elemwise)
 
+# cast
+reg.register_pattern("cast", OpPattern.ELEMWISE)
+reg.register_schedule("cast", _fschedule_elemwise)
+
+# quantize
+reg.register_pattern("quantize", OpPattern.ELEMWISE)
+reg.register_schedule("quantize", _fschedule_elemwise)
+
 # elemwise sum
 @reg.register_compute("elemwise_sum")
 def compute_elemwise_sum(attrs, inputs, _):
@@ -56,3 +56,7 @@ reg.register_schedule("concatenate", _fschedule_injective)
 # split
 reg.register_pattern("split", OpPattern.INJECTIVE)
 reg.register_schedule("split", _fschedule_injective)
+
+# layout_transform
+reg.register_pattern("layout_transform", OpPattern.INJECTIVE)
+reg.register_schedule("layout_transform", _fschedule_injective)
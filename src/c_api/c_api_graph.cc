@@ -82,6 +82,36 @@ int NNGraphGetJSONAttr(GraphHandle handle,
   API_END();
 }
 
+int NNGraphSetBytesAttr(GraphHandle handle,
+                        const char* key,
+                        const char* data,
+                        nn_uint size) {
+  API_BEGIN();
+  Graph* g = static_cast<Graph*>(handle);
+  g->attrs[std::string(key)] = std::make_shared<any>(std::string(data, size));
+  API_END();
+}
+
+int NNGraphGetBytesAttr(GraphHandle handle,
+                        const char* key,
+                        const char** out_data,
+                        nn_uint* out_size,
+                        int *success) {
+  API_BEGIN();
+  Graph* g = static_cast<Graph*>(handle);
+  auto it = g->attrs.find(std::string(key));
+  if (it != g->attrs.end()) {
+    // point to the attribute, which lives as long as the graph.
+    const std::string& bytes = nnvm::get<std::string>(*it->second);
+    *out_data = bytes.data();
+    *out_size = static_cast<nn_uint>(bytes.length());
+    *success = 1;
+  } else {
+    *success = 0;
+  }
+  API_END();
+}
+
 int NNGraphApplyPasses(GraphHandle src,
                        nn_uint num_pass,
                        const char** pass_names,
@@ -96,3 +126,18 @@ int NNGraphApplyPasses(GraphHandle src,
   *dst = g;
   API_END_HANDLE_ERROR(delete g);
 }
+
+int NNGraphApplyPassesProfile(GraphHandle src,
+                              nn_uint num_pass,
+                              const char** pass_names,
+                              GraphHandle *dst) {
+  Graph* g = new Graph();
+  API_BEGIN();
+  std::vector<std::string> vpass;
+  for (nn_uint i = 0; i < num_pass; ++i) {
+    vpass.emplace_back(std::string(pass_names[i]));
+  }
+  *g = ApplyPasses(*static_cast<Graph*>(src), vpass, true);
+  *dst = g;
+  API_END_HANDLE_ERROR(delete g);
+}
@@ -0,0 +1,133 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file auto_mixed_precision.cc
+ * \brief Run numerically safe operators in float16,
+ *  inserting cast at the precision boundaries.
+ */
+#include <nnvm/graph.h>
+#include <nnvm/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <nnvm/pass.h>
+#include <nnvm/compiler/op_attr_types.h>
+#include <nnvm/top/tensor.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "./graph_transform.h"
+
+namespace nnvm {
+namespace compiler {
+
+// Operators that always run in float16.
+static const std::vector<std::string> kDefaultAllowList = {
+  "conv2d", "conv2d_transpose", "dense", "matmul"
+};
+
+// Operators that always run in float32, i.e. reductions,
+// softmax and operators that can overflow in float16.
+// Operators of kCommReduce pattern are also denied unless allowed.
+static const std::vector<std::string> kDefaultDenyList = {
+  "softmax", "log_softmax", "sum", "mean", "max", "min", "prod",
+  "exp", "log", "avg_pool2d", "global_avg_pool2d", "batch_norm", "cast"
+};
+
+inline std::unordered_set<std::string> GetOpList(
+    const Graph& src, const std::string& key,
+    const std::vector<std::string>& defaults) {
+  const std::vector<std::string>& lst = src.attrs.count(key) ?
+      src.GetAttr<std::vector<std::string> >(key) : defaults;
+  return std::unordered_set<std::string>(lst.begin(), lst.end());
+}
+
+Graph AutoMixedPrecision(Graph src) {
+  static auto& op_pattern = Op::GetAttr<TOpPattern>("TOpPattern");
+  const IndexedGraph& idx = src.indexed_graph();
+  const DTypeVector& dtype_vec = src.GetAttr<DTypeVector>("dtype");
+  std::unordered_set<std::string> allow =
+      GetOpList(src, "amp_allow_list", kDefaultAllowList);
+  std::unordered_set<std::string> deny =
+      GetOpList(src, "amp_deny_list", kDefaultDenyList);
+  // nodes in the new graph whose float outputs are float16.
+  std::unordered_set<const Node*> half_nodes;
+  // cast of the same entry is shared by its consumers.
+  NodeEntryMap<NodeEntry> half_cast, float_cast;
+
+  auto cast_to = [&](const NodeEntry& e, bool to_half) {
+    NodeEntryMap<NodeEntry>& cache = to_half ? half_cast : float_cast;
+    auto it = cache.find(e);
+    if (it != cache.end()) return it->second;
+    std::string name = e.node->attrs.name;
+    if (e.node->num_outputs() != 1) name += "_output" + std::to_string(e.index);
+    NodeEntry ret = MakeNode(
+        "cast", name + (to_half ? "_fp16" : "_fp32"), {e},
+        {{"dtype", to_half ? "float16" : "float32"}});
+    cache[e] = ret;
+    return ret;
+  };
+
+  auto transform = [&](uint32_t nid, const NodePtr& n, std::vector<NodeEntry>* ret) {
+    if (n->is_variable()) return false;
+    const auto& inode = idx[nid];
+    // only rewrite operators with float32 outputs.
+    bool float_op = !deny.count(n->op()->name) &&
+        (allow.count(n->op()->name) ||
+         op_pattern.get(n->op(), kOpaque) != kCommReduce);
+    for (uint32_t i = 0; i < n->num_outputs(); ++i) {
+      if (dtype_vec[idx.entry_id(nid, i)] != top::kFloat32) float_op = false;
+    }
+    bool use_half = false;
+    if (float_op) {
+      if (allow.count(n->op()->name)) {
+        use_half = true;
+      } else {
+        // follow the precision of the inputs.
+        for (const NodeEntry& e : n->inputs) {
+          if (half_nodes.count(e.node.get())) use_half = true;
+        }
+      }
+    }
+    std::vector<NodeEntry> inputs = n->inputs;
+    bool changed = false;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (dtype_vec[idx.entry_id(inode.inputs[i])] != top::kFloat32) continue;
+      bool is_half = half_nodes.count(inputs[i].node.get()) != 0;
+      if (is_half != use_half) {
+        inputs[i] = cast_to(inputs[i], use_half);
+        changed = true;
+      }
+    }
+    if (!changed) {
+      if (use_half) half_nodes.insert(n.get());
+      return false;
+    }
+    NodePtr node = Node::Create();
+    node->attrs = n->attrs;
+    node->inputs = std::move(inputs);
+    node->control_deps = n->control_deps;
+    if (use_half) half_nodes.insert(node.get());
+    ret->clear();
+    for (uint32_t i = 0; i < node->num_outputs(); ++i) {
+      ret->emplace_back(NodeEntry{node, i, 0});
+    }
+    return true;
+  };
+  GraphDelta delta;
+  Graph ret = GraphTransform(src, transform, &delta);
+  // the outputs are kept in float32.
+  for (NodeEntry& e : ret.outputs) {
+    if (half_nodes.count(e.node.get())) e = cast_to(e, false);
+  }
+  // the casts keep the shapes, only the types change.
+  CarryOverEntryAttr<TShape>(src, delta, "shape", TShape(), &ret);
+  return ret;
+}
+
+NNVM_REGISTER_PASS(AutoMixedPrecision)
+.describe("Run the operators in allow list and the operators following "\
+          "float16 inputs in float16, except the operators in deny list.")
+.set_body(AutoMixedPrecision)
+.set_change_graph(true)
+.depend_graph_attr("dtype");
+
+}  // namespace compiler
+}  // namespace nnvm
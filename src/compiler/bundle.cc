@@ -0,0 +1,168 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file bundle.cc
+ * \brief Single file bundle of the execution graph, the parameters
+ *  and the reference to the compiled module.
+ *
+ *    uint64_t magic, reserved
+ *    padding to kParamFileAlign
+ *    sections, the parameters first to keep their payloads aligned
+ *    uint64_t num_sections, (name, offset, size) of each section
+ *    uint64_t offset of the section index
+ *
+ *  The sections are "params" in the format of param_file.h,
+ *  "graph" as graph json and "module" as the path of the
+ *  module library relative to the bundle, followed by any
+ *  extra sections of text, such as the graphs of other batch sizes.
+*/
+#include <dmlc/memory_io.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "./param_file.h"
+
+namespace nnvm {
+namespace compiler {
+
+using tvm::runtime::TVMArgs;
+using tvm::runtime::TVMRetValue;
+using tvm::runtime::PackedFunc;
+
+/*! \brief Magic number for bundle file */
+constexpr uint64_t kNNVMBundleMagic = 0xF7E58D4F05049CB9;
+
+/*! \brief Location of a section in the bundle. */
+struct BundleSection {
+  std::string name;
+  uint64_t offset;
+  uint64_t size;
+};
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._save_bundle")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    // path, graph json, module path, number of extra sections,
+    // name and text of each extra section, followed by
+    // name, array and codec of each parameter
+    std::string path = args[0];
+    std::string graph_json = args[1];
+    std::string module_path = args[2];
+    int num_extra = args[3];
+    int begin = 4 + 2 * num_extra;
+    CHECK_EQ((args.size() - begin) % 3, 0);
+    std::vector<std::string> extra_names, extra_text;
+    for (int i = 4; i < begin; i += 2) {
+      std::string name = args[i];
+      CHECK(name != "params" && name != "graph" && name != "module")
+          << "Reserved bundle section name " << name;
+      extra_names.push_back(name);
+      extra_text.emplace_back(args[i + 1].operator std::string());
+    }
+    std::vector<std::string> names;
+    std::vector<DLTensor*> arrays;
+    std::vector<uint32_t> codecs;
+    for (int i = begin; i < args.size(); i += 3) {
+      names.emplace_back(args[i].operator std::string());
+      arrays.emplace_back(args[i + 1].operator DLTensor*());
+      codecs.emplace_back(static_cast<uint32_t>(args[i + 2].operator int()));
+    }
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(path.c_str(), "w"));
+    uint64_t header = kNNVMBundleMagic, reserved = 0;
+    fo->Write(&header, sizeof(header));
+    fo->Write(&reserved, sizeof(reserved));
+    std::string padding(kParamFileAlign - sizeof(header) - sizeof(reserved), '\0');
+    fo->Write(padding.data(), padding.length());
+    std::vector<BundleSection> sections;
+    uint64_t offset = kParamFileAlign;
+    uint64_t params_size = SaveParamFile(fo.get(), names, arrays, codecs);
+    sections.push_back(BundleSection{"params", offset, params_size});
+    offset += params_size;
+    fo->Write(graph_json.data(), graph_json.length());
+    sections.push_back(BundleSection{"graph", offset, graph_json.length()});
+    offset += graph_json.length();
+    fo->Write(module_path.data(), module_path.length());
+    sections.push_back(BundleSection{"module", offset, module_path.length()});
+    offset += module_path.length();
+    for (size_t i = 0; i < extra_names.size(); ++i) {
+      fo->Write(extra_text[i].data(), extra_text[i].length());
+      sections.push_back(BundleSection{extra_names[i], offset, extra_text[i].length()});
+      offset += extra_text[i].length();
+    }
+    uint64_t sz = static_cast<uint64_t>(sections.size());
+    fo->Write(&sz, sizeof(sz));
+    for (const BundleSection& s : sections) {
+      fo->Write(s.name);
+      fo->Write(&s.offset, sizeof(s.offset));
+      fo->Write(&s.size, sizeof(s.size));
+    }
+    fo->Write(&offset, sizeof(offset));
+  });
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._load_bundle")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    std::string path = args[0];
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+    const char* data = file->data();
+    size_t size = file->size();
+    uint64_t header, index_offset;
+    CHECK_GE(size, kParamFileAlign + sizeof(index_offset))
+        << "Invalid bundle format";
+    std::memcpy(&header, data, sizeof(header));
+    CHECK_EQ(header, kNNVMBundleMagic) << "Invalid bundle format";
+    std::memcpy(&index_offset, data + size - sizeof(index_offset),
+                sizeof(index_offset));
+    CHECK_LE(index_offset, size - sizeof(index_offset))
+        << "Invalid bundle format";
+    dmlc::MemoryFixedSizeStream strm(
+        file->data() + index_offset, size - sizeof(index_offset) - index_offset);
+    uint64_t sz;
+    CHECK_EQ(strm.Read(&sz, sizeof(sz)), sizeof(sz)) << "Invalid bundle format";
+    std::unordered_map<std::string, BundleSection> sections;
+    for (uint64_t i = 0; i < sz; ++i) {
+      BundleSection s;
+      CHECK(strm.Read(&s.name) &&
+            strm.Read(&s.offset, sizeof(s.offset)) == sizeof(s.offset) &&
+            strm.Read(&s.size, sizeof(s.size)) == sizeof(s.size))
+          << "Invalid bundle format";
+      CHECK(s.offset <= index_offset && s.size <= index_offset - s.offset)
+          << "Invalid bundle format, truncated section " << s.name;
+      sections[s.name] = s;
+    }
+    for (const char* name : {"params", "graph", "module"}) {
+      CHECK(sections.count(name)) << "Cannot find " << name << " in bundle " << path;
+    }
+    const BundleSection& params = sections.at("params");
+    PackedFunc fparams = MappedParamFunction(file, params.offset, params.size);
+    std::string graph_json(data + sections.at("graph").offset,
+                           sections.at("graph").size);
+    std::string module_path(data + sections.at("module").offset,
+                            sections.at("module").size);
+    std::unordered_map<std::string, std::string> extra;
+    for (const auto& kv : sections) {
+      if (kv.first == "params" || kv.first == "graph" || kv.first == "module") continue;
+      extra[kv.first] = std::string(data + kv.second.offset, kv.second.size);
+    }
+    // code 0 to 2 access the parameters, 3 and 4 return the graph
+    // json and the module path, 5 returns the text of the extra
+    // section named by the second argument, empty if there is none.
+    auto packed = [fparams, graph_json, module_path, extra](
+        TVMArgs args, TVMRetValue* rv) {
+      int code = args[0];
+      if (code == 3) {
+        *rv = graph_json;
+      } else if (code == 4) {
+        *rv = module_path;
+      } else if (code == 5) {
+        auto it = extra.find(args[1].operator std::string());
+        *rv = it != extra.end() ? it->second : std::string();
+      } else {
+        fparams.CallPacked(args, rv);
+      }
+    };
+    *rv = PackedFunc(packed);
+  });
+
+}  // namespace compiler
+}  // namespace nnvm
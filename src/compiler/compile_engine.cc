@@ -220,6 +220,20 @@ class CompileEngine {
 
     Schedule sch = fschedule[idx[master_idx].source->op()](
         idx[master_idx].source->attrs, outs, target);
+    // Inline the pad fused into the data read of the master,
+    // unless the schedule of the master already placed it.
+    static const nnvm::Op* pad_op = nnvm::Op::Get("pad");
+    const auto& master = idx[master_idx];
+    if (!master.inputs.empty()) {
+      uint32_t pad_nid = master.inputs[0].node_id;
+      if (!idx[pad_nid].source->is_variable() &&
+          idx[pad_nid].source->op() == pad_op) {
+        Stage stage = sch[tensor_vec[idx.entry_id(pad_nid, 0)]->op];
+        if (stage->attach_type == kGroupRoot && !stage->is_output) {
+          stage.compute_inline();
+        }
+      }
+    }
 
     // store extra return values
     if (readable_name != nullptr) {
@@ -0,0 +1,73 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file estimate_cost.cc
+ * \brief Annotate each node with its floating point operations
+ *  and the bytes it reads and writes.
+ */
+#include <nnvm/graph.h>
+#include <nnvm/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <nnvm/pass.h>
+#include <nnvm/compiler/op_attr_types.h>
+#include <vector>
+#include "./compile_engine.h"
+
+namespace nnvm {
+namespace compiler {
+
+nnvm::Graph EstimateCost(nnvm::Graph g) {
+  static auto& fcost = Op::GetAttr<FEstimateCost>("FEstimateCost");
+  const IndexedGraph& idx = g.indexed_graph();
+  const ShapeVector& shape_vec = g.GetAttr<ShapeVector>("shape");
+  const DTypeVector& dtype_vec = g.GetAttr<DTypeVector>("dtype");
+  // entries of unknown type are not counted.
+  auto entry_bytes = [&](uint32_t eid) -> uint64_t {
+    if (dtype_vec[eid] == -1) return 0;
+    tvm::Type t = GetTVMType(dtype_vec[eid]);
+    return shape_vec[eid].Size() * ((t.bits() * t.lanes() + 7) / 8);
+  };
+
+  std::vector<uint64_t> flop(idx.num_nodes(), 0);
+  std::vector<uint64_t> bytes_read(idx.num_nodes(), 0);
+  std::vector<uint64_t> bytes_written(idx.num_nodes(), 0);
+  std::vector<TShape> ishapes, oshapes;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    ishapes.clear();
+    oshapes.clear();
+    for (const auto& e : inode.inputs) {
+      uint32_t eid = idx.entry_id(e);
+      ishapes.push_back(shape_vec[eid]);
+      bytes_read[nid] += entry_bytes(eid);
+    }
+    for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+      uint32_t eid = idx.entry_id(nid, i);
+      oshapes.push_back(shape_vec[eid]);
+      bytes_written[nid] += entry_bytes(eid);
+    }
+    // operators without an estimate are counted as zero flop.
+    if (fcost.count(inode.source->op())) {
+      flop[nid] = fcost[inode.source->op()](inode.source->attrs, ishapes, oshapes);
+    }
+  }
+  g.attrs["flop"] = std::make_shared<any>(std::move(flop));
+  g.attrs["bytes_read"] = std::make_shared<any>(std::move(bytes_read));
+  g.attrs["bytes_written"] = std::make_shared<any>(std::move(bytes_written));
+  return g;
+}
+
+NNVM_REGISTER_PASS(EstimateCost)
+.describe("Estimate the flop, bytes read and bytes written of each node")
+.set_body(EstimateCost)
+.set_change_graph(false)
+.depend_graph_attr("shape")
+.depend_graph_attr("dtype")
+.provide_graph_attr("flop")
+.provide_graph_attr("bytes_read")
+.provide_graph_attr("bytes_written");
+
+DMLC_JSON_ENABLE_ANY(std::vector<uint64_t>, list_uint64);
+
+}  // namespace compiler
+}  // namespace nnvm
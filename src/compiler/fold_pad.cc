@@ -0,0 +1,132 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file fold_pad.cc
+ * \brief Fold explicit pad operator into the padding of
+ *  the consuming convolution or pooling operator.
+ */
+#include <nnvm/graph.h>
+#include <nnvm/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <nnvm/pass.h>
+#include <nnvm/compiler/op_attr_types.h>
+#include <nnvm/top/nn.h>
+#include <limits>
+#include <sstream>
+#include "./graph_transform.h"
+#include "./pattern_util.h"
+
+namespace nnvm {
+namespace compiler {
+
+// Get the height and width axis of a 4D data layout.
+inline bool GetSpatialAxis(int layout, int* h_axis, int* w_axis) {
+  if (layout == top::kNCHW) {
+    *h_axis = 2; *w_axis = 3;
+    return true;
+  } else if (layout == top::kNHWC) {
+    *h_axis = 1; *w_axis = 2;
+    return true;
+  }
+  return false;
+}
+
+/*!
+ * \brief Get the symmetric spatial padding that is equivalent to the pad.
+ * \param pad The parameter of pad operator.
+ * \param layout The data layout of the consumer.
+ * \param padding The output padding in (height, width).
+ * \return Whether pad can be expressed as symmetric spatial padding.
+ */
+inline bool GetFoldablePadding(const top::PadParam& pad,
+                               int layout,
+                               TShape* padding) {
+  int h_axis, w_axis;
+  if (!GetSpatialAxis(layout, &h_axis, &w_axis)) return false;
+  if (pad.pad_width.ndim() != 4) return false;
+  for (uint32_t i = 0; i < pad.pad_width.ndim(); ++i) {
+    const Tuple<int>& width = pad.pad_width[i];
+    if (width.ndim() != 2) return false;
+    if (static_cast<int>(i) == h_axis || static_cast<int>(i) == w_axis) {
+      if (width[0] != width[1] || width[0] < 0) return false;
+    } else if (width[0] != 0 || width[1] != 0) {
+      return false;
+    }
+  }
+  *padding = TShape({pad.pad_width[h_axis][0], pad.pad_width[w_axis][0]});
+  return true;
+}
+
+// Create a copy of node with padding increased by extra.
+inline NodePtr AddPadding(const NodePtr& n,
+                          const TShape& padding,
+                          const TShape& extra,
+                          NodeEntry data) {
+  NodePtr node = Node::Create();
+  node->attrs = n->attrs;
+  std::ostringstream os;
+  os << TShape({padding[0] + extra[0], padding[1] + extra[1]});
+  node->attrs.dict["padding"] = os.str();
+  node->op()->attr_parser(&(node->attrs));
+  node->inputs = n->inputs;
+  node->inputs[0] = data;
+  node->control_deps = n->control_deps;
+  return node;
+}
+
+Graph FoldPad(nnvm::Graph src) {
+  const IndexedGraph& idx = src.indexed_graph();
+  std::vector<uint32_t> ref_count = GetNodeRefCounts(idx);
+  static const Op* pad_op = Op::Get("pad");
+  static const Op* conv2d_op = Op::Get("conv2d");
+  static const Op* max_pool2d_op = Op::Get("max_pool2d");
+  static const Op* avg_pool2d_op = Op::Get("avg_pool2d");
+
+  auto transform = [&](uint32_t nid, const NodePtr& n, std::vector<NodeEntry>* ret) {
+    if (n->is_variable()) return false;
+    if (n->op() != conv2d_op &&
+        n->op() != max_pool2d_op &&
+        n->op() != avg_pool2d_op) return false;
+    // only fold when the pad result is consumed by this node alone.
+    uint32_t pad_nid = idx[nid].inputs[0].node_id;
+    if (idx[pad_nid].source->op() != pad_op ||
+        ref_count[pad_nid] != 1) return false;
+    const NodePtr& pad = n->inputs[0].node;
+    CHECK(pad->op() == pad_op);
+    const auto& pad_param = nnvm::get<top::PadParam>(pad->attrs.parsed);
+    TShape extra;
+    if (n->op() == conv2d_op) {
+      const auto& param = nnvm::get<top::Conv2DParam>(n->attrs.parsed);
+      // convolution implicitly pads with zero
+      if (pad_param.pad_value != 0.0f) return false;
+      if (!GetFoldablePadding(pad_param, param.layout, &extra)) return false;
+      *ret = {NodeEntry{AddPadding(n, param.padding, extra, pad->inputs[0]), 0, 0}};
+    } else {
+      const auto& param = nnvm::get<top::Pool2DParam>(n->attrs.parsed);
+      if (n->op() == max_pool2d_op) {
+        // max pooling implicitly pads with the lowest value.
+        if (pad_param.pad_value > std::numeric_limits<float>::lowest()) return false;
+      } else {
+        // average pooling counts the implicit zero padding.
+        if (pad_param.pad_value != 0.0f) return false;
+      }
+      if (!GetFoldablePadding(pad_param, param.layout, &extra)) return false;
+      *ret = {NodeEntry{AddPadding(n, param.padding, extra, pad->inputs[0]), 0, 0}};
+    }
+    return true;
+  };
+  GraphDelta delta;
+  Graph ret = GraphTransform(src, transform, &delta);
+  // the replaced entries keep their shape and type.
+  CarryOverEntryAttr<TShape>(src, delta, "shape", TShape(), &ret);
+  CarryOverEntryAttr<int>(src, delta, "dtype", -1, &ret);
+  return ret;
+}
+
+NNVM_REGISTER_PASS(FoldPad)
+.describe("Fold symmetric zero pad into the padding of conv2d and pooling. "
+          "Other pads are fused into the data read of the consumer by GraphFusePartition.")
+.set_body(FoldPad)
+.set_change_graph(true);
+
+}  // namespace compiler
+}  // namespace nnvm
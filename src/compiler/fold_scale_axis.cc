@@ -97,19 +97,23 @@ bool DetectScaleAxis(const IndexedGraph& idx,
         MatchBroadcast1DAxis(oshape, shape_vec[idx.entry_id(a)]);
     if (axis.first != -1 &&
         shape_vec[idx.entry_id(b)] == oshape) {
-      if (ref_count[a.node_id] != 1) return false;
       if (is_forward && ref_count[nid] != 1) return false;
       if (!is_forward && ref_count[b.node_id] != 1) return false;
       const IndexedGraph::Node& anode = idx[a.node_id];
       // mark the current entry.
       FoldChainEntry& e = (*chain)[nid];
-      if (anode.source->is_variable()) {
-        e.fold_input_index = 1 - i;
-        e.scale_entry = inode.source->inputs[1 - i];
-      } else if (anode.source->op()  == expand_dims &&
-                 shape_vec[idx.entry_id(anode.source->inputs[0])].ndim() == 1) {
+      if (anode.source->op()  == expand_dims &&
+          shape_vec[idx.entry_id(anode.source->inputs[0])].ndim() == 1) {
+        // the expand_dims node is dropped after folding.
+        if (ref_count[a.node_id] != 1) return false;
         e.fold_input_index = 1 - i;
         e.scale_entry = anode.source->inputs[0];
+      } else if (anode.source->is_variable() ||
+                 shape_vec[idx.entry_id(a)].ndim() == 1) {
+        // scale on the last axis, e.g. batch_norm after dense,
+        // is not expanded and can be used directly.
+        e.fold_input_index = 1 - i;
+        e.scale_entry = inode.source->inputs[i];
       } else {
         return false;
       }
@@ -314,11 +318,18 @@ Graph FoldScaleAxis(Graph src) {
       return true;
     }
   };
-  return GraphTransform(src, transform);
+  GraphDelta delta;
+  Graph ret = GraphTransform(src, transform, &delta);
+  // the replaced entries keep their shape and type.
+  CarryOverEntryAttr<TShape>(src, delta, "shape", TShape(), &ret);
+  CarryOverEntryAttr<int>(src, delta, "dtype", -1, &ret);
+  return ret;
 }
 
 NNVM_REGISTER_PASS(FoldScaleAxis)
-.set_body(FoldScaleAxis);
+.set_body(FoldScaleAxis)
+.set_change_graph(true)
+.depend_graph_attr("shape");
 
 // property registration.
 bool ReluScaleAxisBackward(
@@ -492,7 +503,115 @@ bool Conv2DScaleAxisForward(
   const Conv2DParam& param = nnvm::get<Conv2DParam>(attrs.parsed);
   if ((*in_info)[0].kind != kPending) return false;
   // only optimize for nchw for now
+  if (param.layout != top::kNCHW || (*in_info)[0].axis != 1) return false;
+  // weight is (channels, in_channels / groups, kh, kw)
+  int weight_axis;
+  if (param.groups == 1) {
+    weight_axis = 1;
+  } else if (param.groups == param.channels &&
+             static_cast<dim_t>(param.groups) == in_shape[0][1]) {
+    // depthwise: each input channel maps to one weight row.
+    weight_axis = 0;
+  } else {
+    return false;
+  }
+  (*in_info)[1].kind = kMulConsumer;
+  (*in_info)[1].axis = weight_axis;
+  (*in_info)[1].source = (*in_info)[0].source;
+  return true;
+}
+
+NNVM_REGISTER_OP(conv2d)
+.set_attr<FScaleAxisBackward>("FScaleAxisBackward", Conv2DScaleAxisBackward);
+
+NNVM_REGISTER_OP(conv2d)
+.set_attr<FScaleAxisForward>("FScaleAxisForward", Conv2DScaleAxisForward);
+
+bool Conv2DTransposeScaleAxisBackward(
+    const NodeAttrs& attrs,
+    const std::vector<TShape>& in_shape,
+    const std::vector<TShape>& out_shape,
+    const FoldChainInfo& out_info,
+    std::vector<FoldChainInfo>* in_axis) {
+  using top::Conv2DTransposeParam;
+  const Conv2DTransposeParam& param = nnvm::get<Conv2DTransposeParam>(attrs.parsed);
+  if (out_info.kind != kPending) return false;
+  // weight is (in_channels, channels / groups, kh, kw),
+  // output channels only map to the weight axis without group.
+  if (param.layout == top::kNCHW && out_info.axis == 1 && param.groups == 1) {
+    (*in_axis)[1].kind = kMulConsumer;
+    (*in_axis)[1].axis = 1;
+    (*in_axis)[1].source = out_info.source;
+    if (param.use_bias) {
+      (*in_axis)[2].kind = kMulConsumer;
+      (*in_axis)[2].axis = 0;
+      (*in_axis)[2].source = out_info.source;
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool Conv2DTransposeScaleAxisForward(
+    const NodeAttrs& attrs,
+    const std::vector<TShape>& in_shape,
+    const std::vector<TShape>& out_shape,
+    std::vector<FoldChainInfo>* in_info,
+    FoldChainInfo* out_info) {
+  using top::Conv2DTransposeParam;
+  const Conv2DTransposeParam& param = nnvm::get<Conv2DTransposeParam>(attrs.parsed);
+  if ((*in_info)[0].kind != kPending) return false;
   if (param.layout == top::kNCHW && (*in_info)[0].axis == 1) {
+    (*in_info)[1].kind = kMulConsumer;
+    (*in_info)[1].axis = 0;
+    (*in_info)[1].source = (*in_info)[0].source;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+NNVM_REGISTER_OP(conv2d_transpose)
+.set_attr<FScaleAxisBackward>("FScaleAxisBackward", Conv2DTransposeScaleAxisBackward);
+
+NNVM_REGISTER_OP(conv2d_transpose)
+.set_attr<FScaleAxisForward>("FScaleAxisForward", Conv2DTransposeScaleAxisForward);
+
+bool DenseScaleAxisBackward(
+    const NodeAttrs& attrs,
+    const std::vector<TShape>& in_shape,
+    const std::vector<TShape>& out_shape,
+    const FoldChainInfo& out_info,
+    std::vector<FoldChainInfo>* in_axis) {
+  using top::DenseParam;
+  const DenseParam& param = nnvm::get<DenseParam>(attrs.parsed);
+  if (out_info.kind != kPending) return false;
+  // weight is (units, input_dim), scale on units.
+  if (out_info.axis == static_cast<int>(out_shape[0].ndim()) - 1) {
+    (*in_axis)[1].kind = kMulConsumer;
+    (*in_axis)[1].axis = 0;
+    (*in_axis)[1].source = out_info.source;
+    if (param.use_bias) {
+      (*in_axis)[2].kind = kMulConsumer;
+      (*in_axis)[2].axis = 0;
+      (*in_axis)[2].source = out_info.source;
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool DenseScaleAxisForward(
+    const NodeAttrs& attrs,
+    const std::vector<TShape>& in_shape,
+    const std::vector<TShape>& out_shape,
+    std::vector<FoldChainInfo>* in_info,
+    FoldChainInfo* out_info) {
+  if ((*in_info)[0].kind != kPending) return false;
+  // scale on input_dim.
+  if ((*in_info)[0].axis == static_cast<int>(in_shape[0].ndim()) - 1) {
     (*in_info)[1].kind = kMulConsumer;
     (*in_info)[1].axis = 1;
     (*in_info)[1].source = (*in_info)[0].source;
@@ -502,11 +621,11 @@ bool Conv2DScaleAxisForward(
   }
 }
 
-NNVM_REGISTER_OP(conv2d)
-.set_attr<FScaleAxisBackward>("FScaleAxisBackward", Conv2DScaleAxisBackward);
+NNVM_REGISTER_OP(dense)
+.set_attr<FScaleAxisBackward>("FScaleAxisBackward", DenseScaleAxisBackward);
 
-NNVM_REGISTER_OP(conv2d)
-.set_attr<FScaleAxisForward>("FScaleAxisForward", Conv2DScaleAxisForward);
+NNVM_REGISTER_OP(dense)
+.set_attr<FScaleAxisForward>("FScaleAxisForward", DenseScaleAxisForward);
 
 }  // namespace compiler
 }  // namespace nnvm
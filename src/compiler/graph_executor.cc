@@ -0,0 +1,464 @@
+/*!
+ * Copyright (c) 2018 by Contributors
+ * \file graph_executor.cc
+ * \brief Multithreaded executor of the graph produced by GraphFuseCompile.
+ *
+ *  The storage of the memory plan is allocated once when the executor
+ *  is created. When the graph carries the node_level of ParallelSchedule,
+ *  the levels run in order and the nodes of a level run on a work
+ *  stealing thread pool, which is the concurrency the memory plan of
+ *  such a graph allows. Otherwise the nodes run in order on the caller.
+*/
+#include <nnvm/graph.h>
+#include <nnvm/graph_attr_types.h>
+#include <nnvm/pass_functions.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "./graph_runtime.h"
+
+namespace nnvm {
+namespace compiler {
+
+using tvm::runtime::TVMArgs;
+using tvm::runtime::TVMRetValue;
+using tvm::runtime::PackedFunc;
+using tvm::runtime::Module;
+using tvm::runtime::ModuleNode;
+
+/*!
+ * \brief Thread pool that runs a batch of tasks to completion.
+ *  Each thread has its own queue and steals from the back of the
+ *  queues of the others once its own is empty. The calling thread
+ *  works as thread 0, so a pool of n threads starts n - 1 workers.
+ */
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(int num_threads) {
+    CHECK_GE(num_threads, 1);
+    for (int i = 0; i < num_threads; ++i) {
+      queues_.emplace_back(new TaskQueue());
+    }
+    for (int i = 1; i < num_threads; ++i) {
+      threads_.emplace_back([this, i]() { this->WorkerLoop(i); });
+    }
+  }
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& t : threads_) t.join();
+  }
+  /*!
+   * \brief Run fn on each task and wait for all of them.
+   *  The first exception thrown by fn is rethrown.
+   * \param tasks The tasks.
+   * \param queue The initial queue of each task, modulo the number of threads.
+   * \param fn The function to run a task.
+   */
+  void Run(const std::vector<uint32_t>& tasks,
+           const std::vector<int>& queue,
+           const std::function<void(uint32_t)>& fn) {
+    fn_ = &fn;
+    pending_ = tasks.size();
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      TaskQueue* q = queues_[static_cast<size_t>(queue[i]) % queues_.size()].get();
+      std::lock_guard<std::mutex> lock(q->mutex);
+      q->tasks.push_back(tasks[i]);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++epoch_;
+    }
+    start_.notify_all();
+    this->Drain(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return pending_ == 0; });
+    if (error_ != nullptr) {
+      std::exception_ptr e = error_;
+      error_ = nullptr;
+      std::rethrow_exception(e);
+    }
+  }
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<uint32_t> tasks;
+  };
+  // take a task from the front of the own queue, or steal one
+  bool Pop(int tid, uint32_t* task) {
+    for (size_t k = 0; k < queues_.size(); ++k) {
+      TaskQueue* q = queues_[(tid + k) % queues_.size()].get();
+      std::lock_guard<std::mutex> lock(q->mutex);
+      if (q->tasks.empty()) continue;
+      if (k == 0) {
+        *task = q->tasks.front();
+        q->tasks.pop_front();
+      } else {
+        *task = q->tasks.back();
+        q->tasks.pop_back();
+      }
+      return true;
+    }
+    return false;
+  }
+  // run tasks until all the queues are empty
+  void Drain(int tid) {
+    uint32_t task;
+    while (pending_ != 0 && this->Pop(tid, &task)) {
+      try {
+        (*fn_)(task);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_ == nullptr) error_ = std::current_exception();
+      }
+      if (--pending_ == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_all();
+      }
+    }
+  }
+  void WorkerLoop(int tid) {
+    uint64_t epoch = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [this, epoch]() { return stop_ || epoch_ != epoch; });
+        if (stop_) return;
+        epoch = epoch_;
+      }
+      this->Drain(tid);
+    }
+  }
+  // the queue of each thread
+  std::vector<std::unique_ptr<TaskQueue> > queues_;
+  // the worker threads
+  std::vector<std::thread> threads_;
+  // the function of the current batch
+  const std::function<void(uint32_t)>* fn_{nullptr};
+  // number of tasks of the current batch that are not done
+  std::atomic<size_t> pending_{0};
+  // protects the fields below
+  std::mutex mutex_;
+  std::condition_variable start_, done_;
+  uint64_t epoch_{0};
+  bool stop_{false};
+  std::exception_ptr error_;
+};
+
+/*!
+ * \brief Executor of the graph produced by GraphFuseCompile.
+ *  The functions "set_input", "get_output", "get_num_outputs" and "run"
+ *  follow the convention of the TVM graph runtime.
+ */
+class GraphExecutor : public ModuleNode {
+ public:
+  ~GraphExecutor() {
+    for (DLTensor* t : storage_) {
+      TVMArrayFree(t);
+    }
+  }
+
+  const char* type_key() const final {
+    return "NNVMGraphExecutor";
+  }
+
+  PackedFunc GetFunction(const std::string& name,
+                         const std::shared_ptr<ModuleNode>& sptr_to_self) final {
+    if (name == "set_input") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          if (args[0].type_code() == kStr) {
+            this->SetInput(this->GetInputIndex(args[0]), args[1]);
+          } else {
+            this->SetInput(args[0], args[1]);
+          }
+        });
+    } else if (name == "get_output") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          this->GetOutput(args[0], args[1]);
+        });
+    } else if (name == "get_num_outputs") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          *rv = static_cast<int>(graph_.indexed_graph().outputs().size());
+        });
+    } else if (name == "run") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+          this->Run();
+        });
+    } else {
+      return PackedFunc();
+    }
+  }
+
+  /*!
+   * \brief Initialize the executor.
+   * \param graph_json The json of the execution graph.
+   * \param module The module containing the compiled functions.
+   * \param ctx The context of the storage and the functions.
+   * \param num_threads The number of threads to run a level,
+   *  0 for the number of cores.
+   */
+  void Init(const std::string& graph_json, Module module,
+            TVMContext ctx, int num_threads) {
+    graph_ = nnvm::pass::LoadJSON(graph_json);
+    module_ = module;
+    ctx_ = ctx;
+    this->SetupStorage();
+    this->SetupOpExecs();
+    this->SetupSchedule(num_threads);
+  }
+
+  int GetInputIndex(const std::string& name) const {
+    const IndexedGraph& idx = graph_.indexed_graph();
+    for (size_t i = 0; i < idx.input_nodes().size(); ++i) {
+      if (idx[idx.input_nodes()[i]].source->attrs.name == name) {
+        return static_cast<int>(i);
+      }
+    }
+    LOG(FATAL) << "cannot find " << name << " among the inputs";
+    return -1;
+  }
+
+  void SetInput(int index, DLTensor* data) {
+    const IndexedGraph& idx = graph_.indexed_graph();
+    CHECK_LT(static_cast<size_t>(index), idx.input_nodes().size());
+    uint32_t eid = idx.entry_id(idx.input_nodes()[index], 0);
+    CHECK_EQ(TVMArrayCopyFromTo(data, &data_entry_[eid], nullptr), 0)
+        << TVMGetLastError();
+  }
+
+  void GetOutput(int index, DLTensor* data) {
+    const IndexedGraph& idx = graph_.indexed_graph();
+    CHECK_LT(static_cast<size_t>(index), idx.outputs().size());
+    uint32_t eid = idx.entry_id(idx.outputs()[index]);
+    CHECK_EQ(TVMArrayCopyFromTo(&data_entry_[eid], data, nullptr), 0)
+        << TVMGetLastError();
+  }
+
+  void Run() {
+    if (pool_ == nullptr) {
+      for (const auto& fexec : op_execs_) {
+        if (fexec) fexec();
+      }
+      return;
+    }
+    for (size_t i = 0; i < levels_.size(); ++i) {
+      if (levels_[i].size() == 1) {
+        op_execs_[levels_[i][0]]();
+      } else {
+        pool_->Run(levels_[i], level_streams_[i], run_node_);
+      }
+    }
+  }
+
+ private:
+  // allocate the storage of the memory plan, and the entries in it.
+  void SetupStorage() {
+    const IndexedGraph& idx = graph_.indexed_graph();
+    const ShapeVector& shape_vec = graph_.GetAttr<ShapeVector>("shape");
+    const std::vector<std::string>& dltype_vec =
+        graph_.GetAttr<std::vector<std::string> >("dltype");
+    const StorageVector& storage_id = graph_.GetAttr<StorageVector>("storage_id");
+    std::vector<size_t> pool_bytes;
+    std::vector<TVMType> dtype(idx.num_node_entries());
+    for (uint32_t eid = 0; eid < idx.num_node_entries(); ++eid) {
+      int sid = storage_id[eid];
+      CHECK_GE(sid, 0) << "Do not support runtime shape op";
+      dtype[eid] = tvm::runtime::String2TVMType(dltype_vec[eid]);
+      size_t bytes = shape_vec[eid].Size() *
+          ((dtype[eid].bits * dtype[eid].lanes + 7) / 8);
+      if (static_cast<size_t>(sid) >= pool_bytes.size()) {
+        pool_bytes.resize(sid + 1, 0);
+      }
+      pool_bytes[sid] = std::max(pool_bytes[sid], bytes);
+    }
+    for (size_t bytes : pool_bytes) {
+      // allocate as float32 words to keep the alignment.
+      int64_t shape[] = {static_cast<int64_t>((bytes + 3) / 4)};
+      DLTensor* t;
+      CHECK_EQ(TVMArrayAlloc(shape, 1, kDLFloat, 32, 1,
+                             static_cast<int>(ctx_.device_type),
+                             ctx_.device_id, &t), 0) << TVMGetLastError();
+      storage_.push_back(t);
+    }
+    entry_shape_.resize(idx.num_node_entries());
+    data_entry_.resize(idx.num_node_entries());
+    for (uint32_t eid = 0; eid < idx.num_node_entries(); ++eid) {
+      const TShape& shape = shape_vec[eid];
+      entry_shape_[eid].assign(shape.begin(), shape.end());
+      DLTensor& t = data_entry_[eid];
+      t.data = storage_[storage_id[eid]]->data;
+      t.ctx = ctx_;
+      t.ndim = static_cast<int>(shape.ndim());
+      t.dtype = dtype[eid];
+      t.shape = entry_shape_[eid].data();
+      t.strides = nullptr;
+      t.byte_offset = 0;
+    }
+  }
+
+  // the arguments of a compiled function
+  struct OpArgs {
+    std::vector<DLTensor> args;
+    std::vector<TVMValue> arg_values;
+    std::vector<int> arg_tcodes;
+    std::vector<int64_t> shape_data;
+  };
+
+  // create the closure that runs each node.
+  void SetupOpExecs() {
+    static const nnvm::Op* tvm_op = nnvm::Op::Get("tvm_op");
+    const IndexedGraph& idx = graph_.indexed_graph();
+    op_execs_.resize(idx.num_nodes());
+    for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+      const auto& inode = idx[nid];
+      if (inode.source->is_variable()) continue;
+      CHECK(inode.source->op() == tvm_op)
+          << "Can only execute tvm_op, got " << inode.source->op()->name;
+      const TVMOpParam& param = nnvm::get<TVMOpParam>(inode.source->attrs.parsed);
+      std::vector<uint32_t> eids;
+      for (const auto& e : inode.inputs) {
+        eids.push_back(idx.entry_id(e));
+      }
+      for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+        eids.push_back(idx.entry_id(nid, i));
+      }
+      if (param.func_name == "__nop") continue;
+      if (param.func_name == "__copy") {
+        DLTensor* from = &data_entry_[eids[0]];
+        DLTensor* to = &data_entry_[eids.back()];
+        op_execs_[nid] = [from, to]() {
+          CHECK_EQ(TVMArrayCopyFromTo(from, to, nullptr), 0) << TVMGetLastError();
+        };
+        continue;
+      }
+      std::shared_ptr<OpArgs> arg = std::make_shared<OpArgs>();
+      arg->shape_data.resize(eids.size());
+      for (size_t i = 0; i < eids.size(); ++i) {
+        DLTensor t = data_entry_[eids[i]];
+        if (param.flatten_data) {
+          arg->shape_data[i] = std::accumulate(
+              t.shape, t.shape + t.ndim, static_cast<int64_t>(1), std::multiplies<int64_t>());
+          t.ndim = 1;
+        }
+        arg->args.push_back(t);
+      }
+      for (size_t i = 0; i < eids.size(); ++i) {
+        if (param.flatten_data) {
+          arg->args[i].shape = &(arg->shape_data[i]);
+        }
+        TVMValue v;
+        v.v_handle = &(arg->args[i]);
+        arg->arg_values.push_back(v);
+        arg->arg_tcodes.push_back(kArrayHandle);
+      }
+      PackedFunc pf = module_.GetFunction(param.func_name, false);
+      CHECK(pf != nullptr) << "no such function in module: " << param.func_name;
+      op_execs_[nid] = [arg, pf]() {
+        TVMRetValue rv;
+        TVMArgs targs(arg->arg_values.data(), arg->arg_tcodes.data(),
+                      static_cast<int>(arg->arg_values.size()));
+        pf.CallPacked(targs, &rv);
+      };
+    }
+  }
+
+  // group the nodes by the level of the parallel schedule.
+  void SetupSchedule(int num_threads) {
+    if (!graph_.HasAttr("node_level")) return;
+    const ScheduleVector& level = graph_.GetAttr<ScheduleVector>("node_level");
+    const ScheduleVector* stream = nullptr;
+    if (graph_.HasAttr("node_stream")) {
+      stream = &(graph_.GetAttr<ScheduleVector>("node_stream"));
+    }
+    size_t max_width = 0;
+    for (uint32_t nid = 0; nid < level.size(); ++nid) {
+      if (level[nid] < 0 || !op_execs_[nid]) continue;
+      if (static_cast<size_t>(level[nid]) >= levels_.size()) {
+        levels_.resize(level[nid] + 1);
+        level_streams_.resize(level[nid] + 1);
+      }
+      levels_[level[nid]].push_back(nid);
+      level_streams_[level[nid]].push_back(stream != nullptr ? (*stream)[nid] : 0);
+      max_width = std::max(max_width, levels_[level[nid]].size());
+    }
+    // skip the levels without any work.
+    size_t n = 0;
+    for (size_t i = 0; i < levels_.size(); ++i) {
+      if (levels_[i].empty()) continue;
+      levels_[n].swap(levels_[i]);
+      level_streams_[n].swap(level_streams_[i]);
+      ++n;
+    }
+    levels_.resize(n);
+    level_streams_.resize(n);
+    if (num_threads <= 0) {
+      num_threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1U));
+    }
+    num_threads = std::min(num_threads, static_cast<int>(max_width));
+    if (num_threads > 1) {
+      pool_.reset(new WorkStealingPool(num_threads));
+      run_node_ = [this](uint32_t nid) { op_execs_[nid](); };
+    } else {
+      // all the levels run in order on the caller.
+      levels_.clear();
+      level_streams_.clear();
+    }
+  }
+
+  // the execution graph
+  Graph graph_;
+  // the module of the compiled functions
+  Module module_;
+  // the context of the storage
+  TVMContext ctx_;
+  // the storage of the memory plan
+  std::vector<DLTensor*> storage_;
+  // the shape of each entry
+  std::vector<std::vector<int64_t> > entry_shape_;
+  // each entry as a view of its storage
+  std::vector<DLTensor> data_entry_;
+  // the closure running each node, empty for variables and nop
+  std::vector<std::function<void()> > op_execs_;
+  // the nodes of each level of the parallel schedule
+  std::vector<std::vector<uint32_t> > levels_;
+  // the stream of the nodes of each level
+  std::vector<std::vector<int> > level_streams_;
+  // the function run by the pool on a node
+  std::function<void(uint32_t)> run_node_;
+  // the pool, nullptr if the nodes run in order
+  std::unique_ptr<WorkStealingPool> pool_;
+};
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._create_executor")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    // graph json, module, device type, device id, number of threads
+    std::string graph_json = args[0];
+    Module module = args[1];
+    TVMContext ctx;
+    ctx.device_type = static_cast<DLDeviceType>(args[2].operator int());
+    ctx.device_id = args[3];
+    int num_threads = args[4];
+    std::shared_ptr<GraphExecutor> exec = std::make_shared<GraphExecutor>();
+    exec->Init(graph_json, module, ctx, num_threads);
+    *rv = Module(exec);
+  });
+
+}  // namespace compiler
+}  // namespace nnvm
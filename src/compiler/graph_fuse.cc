@@ -39,6 +39,24 @@ DLDataType GetDLType(int type_flag) {
   return Type2TVMType(GetTVMType(type_flag));
 }
 
+/*!
+ * \brief Whether the entry is a pad that is read as the data of a
+ *  conv2d or pooling node, which then inlines the pad in its input stage.
+ */
+inline bool IsFusablePadInput(const IndexedGraph& idx,
+                              const IndexedGraph::Node& inode,
+                              const IndexedGraph::NodeEntry& e) {
+  static const nnvm::Op* pad_op = nnvm::Op::Get("pad");
+  static const nnvm::Op* conv2d_op = nnvm::Op::Get("conv2d");
+  static const nnvm::Op* max_pool2d_op = nnvm::Op::Get("max_pool2d");
+  static const nnvm::Op* avg_pool2d_op = nnvm::Op::Get("avg_pool2d");
+  const nnvm::Op* op = inode.source->op();
+  if (op != conv2d_op && op != max_pool2d_op && op != avg_pool2d_op) return false;
+  if (&e != &inode.inputs[0]) return false;
+  const nnvm::Node* src = idx[e.node_id].source;
+  return !src->is_variable() && src->op() == pad_op;
+}
+
 // Partition the graph into segments
 // Each segment will be compiled into one operator.
 // Need also mark the property of the segment.
@@ -126,6 +144,12 @@ nnvm::Graph GraphFusePartition(nnvm::Graph g) {
       // realize
       master_vec[nid] = nid;
       for (const auto& e : inode.inputs) {
+        if (fuse_vec[e.node_id] == FuseRule::kUknown &&
+            opt_level >= 1 && IsFusablePadInput(idx, inode, e)) {
+          // the pad left by FoldPad is inlined into the data read of the master.
+          fuse_vec[e.node_id] = FuseRule::kFuseToMaster;
+          continue;
+        }
         if (fuse_vec[e.node_id] == FuseRule::kUknown) {
           fuse_vec[e.node_id] = FuseRule::kRealize;
           if (master_vec[e.node_id] == -1) {
@@ -245,6 +269,24 @@ struct FuseEntry {
   GraphFunc compiled_func;
 };
 
+// Estimate the floating point operations of a node by its FEstimateCost,
+// operators without an estimate are counted as zero.
+uint64_t EstimateNodeFLOP(const IndexedGraph& idx,
+                          uint32_t nid,
+                          const ShapeVector& shape_vec) {
+  static auto& fcost = nnvm::Op::GetAttr<FEstimateCost>("FEstimateCost");
+  const auto& inode = idx[nid];
+  if (!fcost.count(inode.source->op())) return 0;
+  std::vector<TShape> ishapes, oshapes;
+  for (const auto& e : inode.inputs) {
+    ishapes.push_back(shape_vec[idx.entry_id(e)]);
+  }
+  for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+    oshapes.push_back(shape_vec[idx.entry_id(nid, i)]);
+  }
+  return fcost[inode.source->op()](inode.source->attrs, ishapes, oshapes);
+}
+
 // Fuse the partitioned graph into segments.
 // Create a new graph with fused noded.
 // Also inheritate attribute shape, dltype from previous graph.
@@ -306,6 +348,17 @@ nnvm::Graph GraphFuseCompile(nnvm::Graph g) {
       }
     }
   }
+  // source nodes and estimated flop of each group
+  std::vector<std::string> group_nodes(idx.num_nodes());
+  std::vector<uint64_t> group_flop(idx.num_nodes(), 0);
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    int root_id = group_vec[nid];
+    if (!group_nodes[root_id].empty()) group_nodes[root_id].push_back(',');
+    group_nodes[root_id].append(inode.source->attrs.name);
+    group_flop[root_id] += EstimateNodeFLOP(idx, nid, shape_vec);
+  }
   // Setup the Subgraph
   std::vector<NodeEntry> subgraph_vec(idx.num_node_entries());
   for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
@@ -342,6 +395,8 @@ nnvm::Graph GraphFuseCompile(nnvm::Graph g) {
     }
   }
   // Start lowering
+  std::unique_ptr<PassPhaseProfiler> lower_phase(
+      new PassPhaseProfiler("GraphFuseCompile.lower"));
   Array<tvm::LoweredFunc> func_list;
   std::unordered_set<const tvm::Node*> func_set;
 
@@ -378,6 +433,7 @@ nnvm::Graph GraphFuseCompile(nnvm::Graph g) {
       }
     }
   }
+  lower_phase.reset();
 
   const nnvm::Op* tvm_op = nnvm::Op::Get("tvm_op");
 
@@ -405,6 +461,8 @@ nnvm::Graph GraphFuseCompile(nnvm::Graph g) {
     param.num_inputs = static_cast<uint32_t>(fe.imap.size());
     param.num_outputs = static_cast<uint32_t>(fe.subgraph.outputs.size());
     param.flatten_data = fe.flatten_data;
+    param.fused_nodes = group_nodes[root_id];
+    param.flop = group_flop[root_id];
     param.UpdateDict(&(np->attrs.dict));
     np->attrs.parsed = std::move(param);
 
@@ -489,12 +547,25 @@ nnvm::Graph GraphFuseCompile(nnvm::Graph g) {
   ret.attrs["shape"] = std::make_shared<any>(std::move(new_shape_vec));
   ret.attrs["dtype"] = std::make_shared<any>(std::move(new_dtype_vec));
   ret.attrs["dltype"] = std::make_shared<any>(std::move(new_dltype_vec));
-  // Setup module
-  static const PackedFunc& fbuild = GetPackedFunc("nnvm.compiler.build_target");
-  tvm::runtime::Module module = fbuild(func_list, target, target_host);
-  ret.attrs["module"] = std::make_shared<any>(std::move(module));
-  ret = nnvm::ApplyPass(ret, "PlanMemory");
-  ret = DecorateMemoryPlan(ret, assign_flag);
+  // Setup module, or only return the lowered functions to be built later.
+  if (g.HasAttr("lower_only") && g.GetAttr<int>("lower_only") != 0) {
+    ret.attrs["lowered_funcs"] = std::make_shared<any>(std::move(func_list));
+  } else {
+    static const PackedFunc& fbuild = GetPackedFunc("nnvm.compiler.build_target");
+    PassPhaseProfiler phase("GraphFuseCompile.build");
+    tvm::runtime::Module module = fbuild(func_list, target, target_host);
+    ret.attrs["module"] = std::make_shared<any>(std::move(module));
+  }
+  {
+    PassPhaseProfiler phase("GraphFuseCompile.PlanMemory");
+    // plan the memory for concurrent execution of the levels.
+    if (g.HasAttr("num_streams")) {
+      ret.attrs["num_streams"] = g.attrs.at("num_streams");
+      ret = nnvm::ApplyPass(ret, "ParallelSchedule");
+    }
+    ret = nnvm::ApplyPass(ret, "PlanMemory");
+    ret = DecorateMemoryPlan(ret, assign_flag);
+  }
   return ret;
 }
 
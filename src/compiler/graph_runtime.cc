@@ -8,6 +8,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/registry.h>
 #include "./graph_runtime.h"
+#include "./param_file.h"
 
 namespace nnvm {
 namespace compiler {
@@ -135,46 +136,65 @@ TVM_REGISTER_GLOBAL("nnvm.compiler._save_param_dict")
   });
 
 
+void LoadNDArrayList(dmlc::Stream* strm,
+                     std::vector<std::string>* names,
+                     std::vector<DLTensor*>* data) {
+  uint64_t header, reserved;
+  CHECK(strm->Read(&header))
+      << "Invalid parameters file format";
+  CHECK(header == kTVMNDArrayListMagic)
+      << "Invalid parameters file format";
+  CHECK(strm->Read(&reserved))
+      << "Invalid parameters file format";
+
+  CHECK(strm->Read(names))
+      << "Invalid parameters file format";
+  uint64_t sz;
+  strm->Read(&sz, sizeof(sz));
+  size_t size = static_cast<size_t>(sz);
+  CHECK(size == names->size())
+      << "Invalid parameters file format";
+  for (size_t i = 0; i < size; ++i) {
+    data->push_back(LoadDLTensor(strm));
+  }
+}
+
+PackedFunc ParamListFunction(std::vector<std::string> names,
+                             std::vector<DLTensor*> data) {
+  auto packed = [data, names](TVMArgs args, TVMRetValue* rv) {
+    int code = args[0];
+    if (code == 0) {
+      *rv = static_cast<int64_t>(data.size());
+    } else if (code == 1) {
+      int index = args[1];
+      *rv = names[index];
+    } else {
+      CHECK_EQ(code, 2);
+      int index = args[1];
+      *rv = static_cast<void*>(data[index]);
+    }
+  };
+  return PackedFunc(packed);
+}
+
 TVM_REGISTER_GLOBAL("nnvm.compiler._load_param_dict")
 .set_body([](TVMArgs args, TVMRetValue *rv) {
     std::string bytes = args[0];
     std::vector<DLTensor*> data;
     std::vector<std::string> names;
-    dmlc::MemoryStringStream memstrm(&bytes);
-    dmlc::Stream* strm = &memstrm;
-
-    uint64_t header, reserved;
-    CHECK(strm->Read(&header))
-        << "Invalid parameters file format";
-    CHECK(header == kTVMNDArrayListMagic)
-        << "Invalid parameters file format";
-    CHECK(strm->Read(&reserved))
-        << "Invalid parameters file format";
-
-    CHECK(strm->Read(&names))
-        << "Invalid parameters file format";
-    uint64_t sz;
-    strm->Read(&sz, sizeof(sz));
-    size_t size = static_cast<size_t>(sz);
-    CHECK(size == names.size())
-        << "Invalid parameters file format";
-    for (size_t i = 0; i < size; ++i) {
-      data.push_back(LoadDLTensor(strm));
-    }
-    auto packed = [data, names](TVMArgs args, TVMRetValue* rv) {
-      int code = args[0];
-      if (code == 0) {
-        *rv = static_cast<int64_t>(data.size());
-      } else if (code == 1) {
-        int index = args[1];
-        *rv = names[index];
-      } else {
-        CHECK_EQ(code, 2);
-        int index = args[1];
-        *rv = static_cast<void*>(data[index]);
+    if (IsParamFile(bytes.data(), bytes.length())) {
+      // aligned format, the tensors are copied out of the bytes.
+      for (const ParamEntry& e : LoadParamIndex(bytes.data(), bytes.length())) {
+        DLTensor* ret = AllocParamTensor(e);
+        DecodeParamPayload(e, bytes.data() + e.offset, ret->data);
+        names.push_back(e.name);
+        data.push_back(ret);
       }
-    };
-    *rv = PackedFunc(packed);
+    } else {
+      dmlc::MemoryStringStream memstrm(&bytes);
+      LoadNDArrayList(&memstrm, &names, &data);
+    }
+    *rv = ParamListFunction(names, data);
   });
 }  // namespace compiler
 }  // namespace nnvm
@@ -7,6 +7,7 @@
 #define NNVM_COMPILER_GRAPH_RUNTIME_H_
 
 #include <nnvm/graph.h>
+#include <tvm/runtime/packed_func.h>
 #include <vector>
 #include <string>
 
@@ -23,15 +24,41 @@ struct TVMOpParam : public dmlc::Parameter<TVMOpParam> {
   uint32_t num_inputs;
   uint32_t num_outputs;
   uint32_t flatten_data;
+  std::string fused_nodes;
+  uint64_t flop;
 
   DMLC_DECLARE_PARAMETER(TVMOpParam) {
     DMLC_DECLARE_FIELD(func_name);
     DMLC_DECLARE_FIELD(num_inputs).set_default(1);
     DMLC_DECLARE_FIELD(num_outputs).set_default(1);
     DMLC_DECLARE_FIELD(flatten_data).set_default(0);
+    DMLC_DECLARE_FIELD(fused_nodes).set_default("")
+    .describe("Comma separated names of the source nodes fused into the op.");
+    DMLC_DECLARE_FIELD(flop).set_default(0)
+    .describe("Estimated floating point operations of the op.");
   }
 };
 
+/*!
+ * \brief Load the tensors of NDArray list format into new cpu arrays.
+ * \param strm The input stream.
+ * \param names The names of the tensors.
+ * \param data The loaded tensors.
+ */
+void LoadNDArrayList(dmlc::Stream* strm,
+                     std::vector<std::string>* names,
+                     std::vector<DLTensor*>* data);
+
+/*!
+ * \brief Get the function to access loaded tensors from python,
+ *  code 0 returns the size, code 1 and 2 return the name
+ *  and the tensor at an index.
+ * \param names The names of the tensors.
+ * \param data The tensors, to be freed by the caller.
+ */
+tvm::runtime::PackedFunc ParamListFunction(std::vector<std::string> names,
+                                           std::vector<DLTensor*> data);
+
 }  // namespace compiler
 }  // namespace nnvm
 #endif   // NNVM_COMPILER_GRAPH_RUNTIME_H_
@@ -7,11 +7,24 @@
 #define NNVM_COMPILER_GRAPH_TRANSFORM_H_
 
 #include <nnvm/graph.h>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace nnvm {
 namespace compiler {
 
+/*!
+ * \brief Correspondence between the entries of a graph and its transform.
+ */
+struct GraphDelta {
+  /*!
+   * \brief the entry of the new graph that replaces each entry
+   *  of the original graph, indexed by the original entry id.
+   */
+  std::vector<NodeEntry> entry_map;
+};
+
 /*!
  * \brief Transform the graph to build a new Graph, in post DFS order.
  *
@@ -24,10 +37,12 @@ namespace compiler {
  *
  *      If empty vector is returned, it means original entries should be kept.
  *
+ * \param delta If not nullptr, records the replacement of each entry.
+ *
  * \tparam FTransform The transformation function.
  */
 template<typename FTransform>
-Graph GraphTransform(Graph graph, FTransform ftransform) {
+Graph GraphTransform(Graph graph, FTransform ftransform, GraphDelta* delta = nullptr) {
   const IndexedGraph& idx = graph.indexed_graph();
   // new nodes
   std::vector<NodeEntry> new_entry_map(idx.num_node_entries());
@@ -115,9 +130,54 @@ Graph GraphTransform(Graph graph, FTransform ftransform) {
       ret.outputs.push_back(graph.outputs[i]);
     }
   }
+  if (delta != nullptr) {
+    delta->entry_map.resize(idx.num_node_entries());
+    for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+      for (uint32_t i = 0 ; i < idx[nid].source->num_outputs(); ++i) {
+        uint32_t eid = idx.entry_id(nid, i);
+        delta->entry_map[eid] = updated[eid] ?
+            new_entry_map[eid] : NodeEntry{idx[nid].weak_ref.lock(), i, 0};
+      }
+    }
+  }
   return ret;
 }
 
+/*!
+ * \brief Carry the entry attribute of a graph over to its transform,
+ *  for transforms that keep the values of the replaced entries.
+ *
+ *  The known values are saved as attr_name + "_seed" on the new graph,
+ *  which the inference passes start from, so that only the entries
+ *  created by the transform are inferred again.
+ *
+ * \param src The original graph.
+ * \param delta The delta recorded by GraphTransform.
+ * \param attr_name The entry attribute, such as "shape" or "dtype".
+ * \param empty_val The value of unknown entries.
+ * \param ret The transformed graph.
+ */
+template<typename AttrType>
+void CarryOverEntryAttr(const Graph& src,
+                        const GraphDelta& delta,
+                        const std::string& attr_name,
+                        const AttrType& empty_val,
+                        Graph* ret) {
+  if (src.attrs.count(attr_name) == 0) return;
+  const std::vector<AttrType>& src_vec =
+      src.GetAttr<std::vector<AttrType> >(attr_name);
+  CHECK_EQ(src_vec.size(), delta.entry_map.size());
+  const IndexedGraph& idx = ret->indexed_graph();
+  std::vector<AttrType> seed(idx.num_node_entries(), empty_val);
+  for (size_t i = 0; i < src_vec.size(); ++i) {
+    const NodeEntry& e = delta.entry_map[i];
+    if (e.node != nullptr && idx.exist(e.node.get())) {
+      seed[idx.entry_id(e)] = src_vec[i];
+    }
+  }
+  ret->attrs[attr_name + "_seed"] = std::make_shared<any>(std::move(seed));
+}
+
 }  // namespace compiler
 }  // namespace nnvm
 
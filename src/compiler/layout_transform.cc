@@ -9,6 +9,11 @@
 #include <nnvm/pass.h>
 #include <nnvm/compiler/op_attr_types.h>
 #include <nnvm/compiler/contrib_op_param.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
 
 namespace nnvm {
 namespace compiler {
@@ -31,13 +36,51 @@ nnvm::NodePtr CreateLayoutTransformNode(const std::string& src,
   return n;
 }
 
+// whether the node is a layout transform from src to dst.
+inline bool IsLayoutTransform(const nnvm::NodePtr& n,
+                              const TLayoutInfo& src,
+                              const TLayoutInfo& dst) {
+  if (n->is_variable() || n->op()->name != "layout_transform") return false;
+  auto sit = n->attrs.dict.find("src_layout");
+  auto dit = n->attrs.dict.find("dst_layout");
+  return (sit != n->attrs.dict.end() && sit->second == src &&
+          dit != n->attrs.dict.end() && dit->second == dst);
+}
+
+/*! \brief A layout choice of an operator with flexible layout. */
+struct LayoutChoice {
+  /*! \brief The minimum cost of the inputs. */
+  double cost{0};
+  /*! \brief The input layouts requested. */
+  std::vector<TLayoutInfo> ilayouts;
+  /*! \brief The output layouts produced. */
+  std::vector<TLayoutInfo> olayouts;
+};
+
 /*!
- * \brief A simple layout transform pass that will
- *  insert layout transform nodes automatically.
+ * \brief Layout transform pass that assigns layouts to the
+ *  operators with flexible layout globally and inserts layout
+ *  transform nodes where the layouts still disagree.
+ *
+ *  Operators that register FTVMLayoutRequest have fixed layouts.
+ *  Layout agnostic(map) operators can run in any layout, and operators
+ *  that register FTVMLayoutSupport can run in the layouts they accept.
+ *  Each of them picks the layout that minimizes the total
+ *  number of elements that need to be transformed. The cost is
+ *  computed by dynamic programming over the producers in topological
+ *  order, and the layouts are decided in reverse topological order,
+ *  so a chain of operators is assigned optimally and a branch
+ *  picks the layout with minimum cost given its consumers.
+ *
+ *  Transforms of the same entry into the same layout are shared,
+ *  and a pair of inverse transforms is cancelled in the rewritten
+ *  graph, including the transforms that were in the source graph.
  */
 nnvm::Graph LayoutTransform(nnvm::Graph src) {
   static auto& op_layout_request =
     nnvm::Op::GetAttr<FTVMLayoutRequest>("FTVMLayoutRequest");
+  static auto& op_layout_support =
+    nnvm::Op::GetAttr<FTVMLayoutSupport>("FTVMLayoutSupport");
   static auto& op_vecop =
     nnvm::Op::GetAttr<FTVMVectorizedOp>("FTVMVectorizedOp");
   static auto& op_pattern = nnvm::Op::GetAttr<TOpPattern>("TOpPattern");
@@ -48,7 +91,12 @@ nnvm::Graph LayoutTransform(nnvm::Graph src) {
 
   const IndexedGraph& idx = src.indexed_graph();
   std::vector<TLayoutInfo> produce_vec(idx.num_node_entries(), GetDefaultLayout());
-  std::vector<nnvm::NodePtr> mirror_vec(idx.num_nodes(), nullptr);
+  // requested input layouts of each node.
+  std::vector<std::vector<TLayoutInfo> > request_vec(idx.num_nodes());
+  std::vector<nnvm::NodePtr> new_node_vec(idx.num_nodes(), nullptr);
+  // whether the node is a map node, or supports the layout by FTVMLayoutSupport.
+  std::vector<bool> map_vec(idx.num_nodes(), false);
+  std::vector<bool> flex_vec(idx.num_nodes(), false);
 
   // use op pattern to decide whether an op is map
   auto is_map_op = [&](size_t nid) {
@@ -64,7 +112,12 @@ nnvm::Graph LayoutTransform(nnvm::Graph src) {
     }
     return is_map;
   };
+  // cost of transforming an entry into another layout.
+  auto transform_cost = [&](uint32_t eid) {
+    return static_cast<double>(shape_vec[eid].Size());
+  };
 
+  // Step 1: decide the layouts of operators with fixed layout.
   for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
     const auto& inode = idx[nid];
     nnvm::NodePtr new_node = nnvm::Node::Create();
@@ -75,7 +128,7 @@ nnvm::Graph LayoutTransform(nnvm::Graph src) {
       CHECK(input_iter != idx.input_nodes().cend());
       size_t input_id = std::distance(idx.input_nodes().cbegin(), input_iter);
       produce_vec[idx.entry_id(nid, 0)] = input_layouts[input_id];
-      mirror_vec[nid] = new_node;
+      new_node_vec[nid] = new_node;
       continue;
     }
 
@@ -83,7 +136,17 @@ nnvm::Graph LayoutTransform(nnvm::Graph src) {
       new_node = op_vecop[inode.source->op()](inode.source);
       new_node->inputs.resize(new_node->num_inputs());
     }
+    new_node_vec[nid] = new_node;
 
+    if (!op_layout_request.count(new_node->op())) {
+      if (is_map_op(nid)) {
+        map_vec[nid] = flex_vec[nid] = true;
+        continue;
+      } else if (op_layout_support.count(new_node->op())) {
+        flex_vec[nid] = true;
+        continue;
+      }
+    }
     // set up output and input layouts
     std::vector<TLayoutInfo> request_ilayouts(new_node->num_inputs(), GetDefaultLayout());
     if (op_layout_request.count(new_node->op())) {
@@ -98,62 +161,197 @@ nnvm::Graph LayoutTransform(nnvm::Graph src) {
         produce_vec[idx.entry_id(nid, i)] = produce_olayouts[i];
       }
     }
+    request_vec[nid] = std::move(request_ilayouts);
+  }
 
-    bool map_layout = is_map_op(nid);
-    if (map_layout) {
-      const TLayoutInfo& layout = produce_vec[idx.entry_id(inode.inputs[0])];
-      for (const auto& e : inode.inputs) {
-        if (produce_vec[idx.entry_id(e)] != layout) {
-          map_layout = false;
-          break;
+  // Consumers of each entry, the number of times an entry is an output.
+  std::vector<std::vector<std::pair<uint32_t, uint32_t> > >
+      consumer_vec(idx.num_node_entries());
+  std::vector<uint32_t> output_count(idx.num_node_entries(), 0);
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    for (uint32_t i = 0; i < inode.inputs.size(); ++i) {
+      consumer_vec[idx.entry_id(inode.inputs[i])].emplace_back(nid, i);
+    }
+  }
+  for (const auto& e : idx.outputs()) {
+    ++output_count[idx.entry_id(e)];
+  }
+
+  // Step 2: forward dynamic programming over the flexible operators.
+  // choice_vec[nid][layout] gives the minimum cost of the subgraph feeding
+  // a flexible node when it runs in the layout.
+  std::vector<std::map<TLayoutInfo, LayoutChoice> > choice_vec(idx.num_nodes());
+  // cost of providing entry e in layout
+  auto input_cost = [&](const IndexedGraph::NodeEntry& e, const TLayoutInfo& layout) {
+    uint32_t eid = idx.entry_id(e);
+    if (!flex_vec[e.node_id]) {
+      return produce_vec[eid] == layout ? 0.0 : transform_cost(eid);
+    }
+    double best = std::numeric_limits<double>::max();
+    for (const auto& kv : choice_vec[e.node_id]) {
+      const LayoutChoice& choice = kv.second;
+      double cost = choice.cost +
+          (choice.olayouts[e.index] == layout ? 0.0 : transform_cost(eid));
+      best = std::min(best, cost);
+    }
+    return best;
+  };
+
+  std::vector<TShape> ishapes;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    if (!flex_vec[nid]) continue;
+    const auto& inode = idx[nid];
+    const nnvm::NodePtr& new_node = new_node_vec[nid];
+    const uint32_t num_inputs = inode.inputs.size();
+    const uint32_t num_outputs = inode.source->num_outputs();
+    // candidate layouts: layouts of inputs and requests of consumers.
+    std::vector<TLayoutInfo> candidates{GetDefaultLayout()};
+    auto add_candidate = [&candidates](const TLayoutInfo& layout) {
+      if (std::find(candidates.begin(), candidates.end(), layout) == candidates.end()) {
+        candidates.push_back(layout);
+      }
+    };
+    for (const auto& e : inode.inputs) {
+      if (flex_vec[e.node_id]) {
+        for (const auto& kv : choice_vec[e.node_id]) {
+          add_candidate(kv.second.olayouts[e.index]);
         }
+      } else {
+        add_candidate(produce_vec[idx.entry_id(e)]);
+      }
+    }
+    for (uint32_t i = 0; i < num_outputs; ++i) {
+      for (const auto& c : consumer_vec[idx.entry_id(nid, i)]) {
+        if (!flex_vec[c.first]) add_candidate(request_vec[c.first][c.second]);
       }
-      if (map_layout) {
-        for (size_t i = 0; i < inode.source->num_outputs(); ++i) {
-          produce_vec[idx.entry_id(nid, i)] = layout;
+    }
+    ishapes.resize(num_inputs);
+    for (uint32_t i = 0; i < num_inputs; ++i) {
+      ishapes[i] = shape_vec[idx.entry_id(inode.inputs[i])];
+    }
+    for (const TLayoutInfo& layout : candidates) {
+      LayoutChoice choice;
+      if (map_vec[nid] || layout == GetDefaultLayout()) {
+        choice.ilayouts.resize(num_inputs, layout);
+        choice.olayouts.resize(num_outputs, layout);
+      } else {
+        choice.ilayouts.resize(num_inputs, GetDefaultLayout());
+        choice.olayouts.resize(num_outputs, GetDefaultLayout());
+        if (num_inputs == 0) continue;
+        choice.ilayouts[0] = layout;
+        if (!op_layout_support[new_node->op()](
+                new_node->attrs, ishapes, &(choice.ilayouts), &(choice.olayouts))) {
+          continue;
         }
+        CHECK_EQ(choice.ilayouts.size(), num_inputs);
+        CHECK_EQ(choice.olayouts.size(), num_outputs);
+      }
+      for (uint32_t i = 0; i < num_inputs; ++i) {
+        choice.cost += input_cost(inode.inputs[i], choice.ilayouts[i]);
       }
+      choice_vec[nid][layout] = std::move(choice);
     }
+  }
 
-    for (size_t i = 0; i < inode.inputs.size(); ++i) {
-      const auto& e = inode.inputs[i];
-      const nnvm::NodePtr& in = mirror_vec[e.node_id];
-      new_node->inputs[i] =
-        nnvm::NodeEntry{in, e.index, e.version};
-
-      TLayoutInfo produce = produce_vec[idx.entry_id(e)];
-      TLayoutInfo request = request_ilayouts[i];
-      if (!map_layout && (produce != request)) {
-        nnvm::NodePtr tnode = CreateLayoutTransformNode(produce, request);
-        tnode->attrs.name =
-          idx[e.node_id].source->attrs.name + "_" + request;
-        tnode->inputs.emplace_back(new_node->inputs[i]);
-        new_node->inputs[i] = nnvm::NodeEntry{tnode, 0, 0};
+  // Step 3: decide the flexible layouts in reverse topological order,
+  // when all the consumers have been decided.
+  for (uint32_t nid = idx.num_nodes(); nid != 0; --nid) {
+    if (!flex_vec[nid - 1]) continue;
+    const auto& inode = idx[nid - 1];
+    const LayoutChoice* best_choice = nullptr;
+    double best_cost = std::numeric_limits<double>::max();
+    for (const auto& kv : choice_vec[nid - 1]) {
+      const LayoutChoice& choice = kv.second;
+      double cost = choice.cost;
+      for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+        uint32_t eid = idx.entry_id(nid - 1, i);
+        for (const auto& c : consumer_vec[eid]) {
+          if (request_vec[c.first][c.second] != choice.olayouts[i]) {
+            cost += transform_cost(eid);
+          }
+        }
+        if (choice.olayouts[i] != GetDefaultLayout()) {
+          cost += output_count[eid] * transform_cost(eid);
+        }
+      }
+      // prefer the default layout on ties, the input transforms can be shared.
+      if (best_choice == nullptr || cost < best_cost ||
+          (cost == best_cost && kv.first == GetDefaultLayout())) {
+        best_choice = &choice;
+        best_cost = cost;
       }
     }
-    mirror_vec[nid] = new_node;
+    CHECK(best_choice != nullptr);
+    for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+      produce_vec[idx.entry_id(nid - 1, i)] = best_choice->olayouts[i];
+    }
+    request_vec[nid - 1] = best_choice->ilayouts;
   }
 
-  std::vector<nnvm::NodeEntry> outputs;
-  for (const auto& e : idx.outputs()) {
-    TLayoutInfo produce = produce_vec[idx.entry_id(e)];
-    if (produce != GetDefaultLayout()) {
-      nnvm::NodePtr tnode = CreateLayoutTransformNode(produce, GetDefaultLayout());
-      tnode->attrs.name =
-        idx[e.node_id].source->attrs.name + "_default";
-      tnode->inputs.emplace_back(
-        nnvm::NodeEntry{mirror_vec[e.node_id], e.index, e.version});
-      outputs.emplace_back(nnvm::NodeEntry{tnode, 0, 0});
-    } else {
-      outputs.emplace_back(
-        nnvm::NodeEntry{mirror_vec[e.node_id], e.index, e.version});
+  // Step 4: rewrite the graph with layout transforms.
+  std::map<std::pair<uint32_t, TLayoutInfo>, nnvm::NodeEntry> transform_cache;
+  auto get_entry = [&](const IndexedGraph::NodeEntry& e,
+                       const TLayoutInfo& request) {
+    uint32_t eid = idx.entry_id(e);
+    const TLayoutInfo& produce = produce_vec[eid];
+    nnvm::NodeEntry in{new_node_vec[e.node_id], e.index, e.version};
+    if (produce == request) return in;
+    auto key = std::make_pair(eid, request);
+    auto it = transform_cache.find(key);
+    if (it != transform_cache.end()) return it->second;
+    nnvm::NodePtr tnode = CreateLayoutTransformNode(produce, request);
+    tnode->attrs.name =
+      idx[e.node_id].source->attrs.name + "_" + request;
+    tnode->inputs.emplace_back(in);
+    nnvm::NodeEntry ret{tnode, 0, 0};
+    transform_cache[key] = ret;
+    return ret;
+  };
+
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    const nnvm::NodePtr& new_node = new_node_vec[nid];
+    for (size_t i = 0; i < inode.inputs.size(); ++i) {
+      new_node->inputs[i] = get_entry(inode.inputs[i], request_vec[nid][i]);
     }
   }
 
   nnvm::Graph ret;
-  ret.outputs = std::move(outputs);
+  for (const auto& e : idx.outputs()) {
+    ret.outputs.emplace_back(get_entry(e, GetDefaultLayout()));
+  }
+
+  // Step 5: cancel the pairs of inverse transforms, whether they come
+  // from the source graph or are inserted above.
+  std::unordered_map<const nnvm::Node*, nnvm::NodeEntry> cancel_map;
+  auto cancelled = [&](const nnvm::NodeEntry& e) {
+    auto it = cancel_map.find(e.node.get());
+    return it != cancel_map.end() ? it->second : e;
+  };
+  nnvm::DFSVisit(ret.outputs, [&](const nnvm::NodePtr& n) {
+    for (nnvm::NodeEntry& e : n->inputs) {
+      e = cancelled(e);
+    }
+    if (n->is_variable() || n->op()->name != "layout_transform") return;
+    const nnvm::NodePtr& in = n->inputs[0].node;
+    if (IsLayoutTransform(in, n->attrs.dict.at("dst_layout"),
+                          n->attrs.dict.at("src_layout"))) {
+      cancel_map[n.get()] = in->inputs[0];
+    }
+  });
+  for (nnvm::NodeEntry& e : ret.outputs) {
+    e = cancelled(e);
+  }
   return ret;
 }
 
+NNVM_REGISTER_PASS(LayoutTransform)
+.describe("Assign layouts to operators and insert layout transforms.")
+.set_body(LayoutTransform)
+.set_change_graph(true)
+.depend_graph_attr("shape")
+.depend_graph_attr("layout_inputs");
+
 }  // namespace compiler
 }  // namespace nnvm
@@ -108,6 +108,13 @@ TVM_REGISTER_GLOBAL("nnvm.graph._move_module")
         MoveCopyAttr<tvm::runtime::Module>(args[1]);
   });
 
+TVM_REGISTER_GLOBAL("nnvm.graph._move_lowered_funcs")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    const nnvm::Graph& g = args[0].AsExtension<Graph>();
+    *rv = const_cast<nnvm::Graph*>(&g)->
+        MoveCopyAttr<tvm::Array<tvm::LoweredFunc> >(args[1]);
+  });
+
 TVM_REGISTER_GLOBAL("nnvm.graph._move_graph")
 .set_body([](TVMArgs args, TVMRetValue *rv) {
     const nnvm::Graph& g = args[0].AsExtension<Graph>();
@@ -0,0 +1,568 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file param_file.cc
+ * \brief Aligned parameter file format that can be memory mapped.
+*/
+#include <dmlc/memory_io.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "./graph_runtime.h"
+#include "./param_file.h"
+
+namespace nnvm {
+namespace compiler {
+
+using tvm::runtime::TVMArgs;
+using tvm::runtime::TVMRetValue;
+using tvm::runtime::PackedFunc;
+
+inline uint64_t AlignOffset(uint64_t offset) {
+  return (offset + kParamFileAlign - 1) / kParamFileAlign * kParamFileAlign;
+}
+
+inline uint64_t GetDataSize(DLDataType dtype, const std::vector<int64_t>& shape) {
+  uint64_t size = 1;
+  for (int64_t dim : shape) {
+    size *= static_cast<uint64_t>(dim);
+  }
+  return size * ((dtype.bits * dtype.lanes + 7) / 8);
+}
+
+inline bool IsFloat32(DLDataType dtype) {
+  return dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1;
+}
+
+// size of the stored payload
+inline uint64_t GetStoredSize(const ParamEntry& e) {
+  if (e.codec == kParamFloat16) {
+    return GetDataSize(DLDataType{kDLFloat, 16, 1}, e.shape);
+  }
+  return GetDataSize(e.dtype, e.shape);
+}
+
+// round to nearest even, overflow to inf.
+inline uint16_t FloatToHalf(float value) {
+  uint32_t f;
+  std::memcpy(&f, &value, sizeof(f));
+  uint32_t sign = (f >> 16) & 0x8000;
+  uint32_t fexp = (f >> 23) & 0xff;
+  uint32_t mant = f & 0x7fffff;
+  if (fexp == 0xff) {
+    // inf or nan
+    return static_cast<uint16_t>(sign | 0x7c00 | (mant ? 0x200 : 0));
+  }
+  int exp = static_cast<int>(fexp) - 127 + 15;
+  if (exp >= 31) return static_cast<uint16_t>(sign | 0x7c00);
+  uint32_t half, rem, halfway;
+  if (exp <= 0) {
+    // subnormal half
+    if (exp < -10) return static_cast<uint16_t>(sign);
+    mant |= 0x800000;
+    uint32_t shift = static_cast<uint32_t>(14 - exp);
+    half = mant >> shift;
+    rem = mant & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {
+    half = (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    rem = mant & 0x1fff;
+    halfway = 0x1000;
+  }
+  // the carry of rounding goes into the exponent.
+  if (rem > halfway || (rem == halfway && (half & 1))) ++half;
+  return static_cast<uint16_t>(sign | half);
+}
+
+inline float HalfToFloat(uint16_t h) {
+  uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+  uint32_t exp = (h >> 10) & 0x1f;
+  uint32_t mant = h & 0x3ff;
+  uint32_t f;
+  if (exp == 0x1f) {
+    f = sign | 0x7f800000 | (mant << 13);
+  } else if (exp != 0) {
+    f = sign | ((exp + 112) << 23) | (mant << 13);
+  } else if (mant == 0) {
+    f = sign;
+  } else {
+    // normalize the subnormal half
+    exp = 113;
+    while (!(mant & 0x400)) {
+      mant <<= 1;
+      --exp;
+    }
+    f = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+  }
+  float value;
+  std::memcpy(&value, &f, sizeof(value));
+  return value;
+}
+
+// FNV-1a over 8 byte words
+inline uint64_t HashBytes(const char* data, uint64_t size) {
+  const uint64_t kPrime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+  uint64_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * kPrime;
+  }
+  return hash;
+}
+
+void ParamEntry::Save(dmlc::Stream* strm) const {
+  strm->Write(name);
+  strm->Write(&dtype, sizeof(dtype));
+  strm->Write(shape);
+  strm->Write(&codec, sizeof(codec));
+  strm->Write(&offset, sizeof(offset));
+  strm->Write(&nbytes, sizeof(nbytes));
+}
+
+bool ParamEntry::Load(dmlc::Stream* strm) {
+  if (!strm->Read(&name)) return false;
+  if (strm->Read(&dtype, sizeof(dtype)) != sizeof(dtype)) return false;
+  if (!strm->Read(&shape)) return false;
+  if (strm->Read(&codec, sizeof(codec)) != sizeof(codec)) return false;
+  if (strm->Read(&offset, sizeof(offset)) != sizeof(offset)) return false;
+  if (strm->Read(&nbytes, sizeof(nbytes)) != sizeof(nbytes)) return false;
+  return true;
+}
+
+// serialize the header and the index
+inline std::string SaveParamHeader(const std::vector<ParamEntry>& index) {
+  std::string bytes;
+  dmlc::MemoryStringStream strm(&bytes);
+  uint64_t header = kTVMNDArrayListMagicV2, reserved = 0;
+  uint64_t sz = static_cast<uint64_t>(index.size());
+  strm.Write(&header, sizeof(header));
+  strm.Write(&reserved, sizeof(reserved));
+  strm.Write(&sz, sizeof(sz));
+  for (const ParamEntry& e : index) {
+    e.Save(&strm);
+  }
+  return bytes;
+}
+
+inline void WritePadding(dmlc::Stream* strm, uint64_t size) {
+  static const char kZeros[kParamFileAlign] = {0};
+  while (size != 0) {
+    uint64_t n = std::min(size, kParamFileAlign);
+    strm->Write(kZeros, n);
+    size -= n;
+  }
+}
+
+uint64_t SaveParamFile(dmlc::Stream* strm,
+                       const std::vector<std::string>& names,
+                       const std::vector<DLTensor*>& arrays,
+                       const std::vector<uint32_t>& codecs) {
+  CHECK_EQ(names.size(), arrays.size());
+  CHECK(codecs.empty() || codecs.size() == arrays.size());
+  std::vector<ParamEntry> index(arrays.size());
+  // the stored payload of each entry
+  std::vector<const char*> payload(arrays.size());
+  std::vector<std::vector<uint16_t> > encoded(arrays.size());
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    const DLTensor* tensor = arrays[i];
+    CHECK_EQ(tensor->ctx.device_type, kDLCPU)
+        << "Can only save cpu tensor " << names[i];
+    ParamEntry& e = index[i];
+    e.name = names[i];
+    e.dtype = tensor->dtype;
+    e.shape.assign(tensor->shape, tensor->shape + tensor->ndim);
+    e.codec = codecs.empty() ? kParamRaw : codecs[i];
+    payload[i] = static_cast<const char*>(tensor->data);
+    if (e.codec == kParamFloat16) {
+      CHECK(IsFloat32(e.dtype))
+          << "float16 storage only applies to float32 tensor " << e.name;
+      const float* src = static_cast<const float*>(tensor->data);
+      encoded[i].resize(GetDataSize(e.dtype, e.shape) / sizeof(float));
+      for (size_t j = 0; j < encoded[i].size(); ++j) {
+        encoded[i][j] = FloatToHalf(src[j]);
+      }
+      payload[i] = reinterpret_cast<const char*>(encoded[i].data());
+    } else {
+      CHECK_EQ(e.codec, kParamRaw)
+          << "Unknown storage codec of " << e.name;
+    }
+    e.nbytes = GetStoredSize(e);
+  }
+  // the size of the index does not depend on the offsets.
+  uint64_t offset = AlignOffset(SaveParamHeader(index).length());
+  // the payloads to be written, duplicated payloads share the offset.
+  std::vector<size_t> unique;
+  std::unordered_map<uint64_t, std::vector<size_t> > hash_map;
+  for (size_t i = 0; i < index.size(); ++i) {
+    ParamEntry& e = index[i];
+    std::vector<size_t>& same_hash = hash_map[HashBytes(payload[i], e.nbytes)];
+    bool found = false;
+    for (size_t j : same_hash) {
+      if (index[j].nbytes == e.nbytes &&
+          std::memcmp(payload[j], payload[i], e.nbytes) == 0) {
+        e.offset = index[j].offset;
+        found = true;
+        break;
+      }
+    }
+    if (found) continue;
+    same_hash.push_back(i);
+    unique.push_back(i);
+    e.offset = offset;
+    offset = AlignOffset(offset + e.nbytes);
+  }
+  std::string header = SaveParamHeader(index);
+  strm->Write(header.data(), header.length());
+  uint64_t pos = header.length();
+  for (size_t i : unique) {
+    WritePadding(strm, index[i].offset - pos);
+    strm->Write(payload[i], index[i].nbytes);
+    pos = index[i].offset + index[i].nbytes;
+  }
+  return pos;
+}
+
+bool IsParamFile(const void* data, size_t size) {
+  uint64_t header;
+  if (size < sizeof(header)) return false;
+  std::memcpy(&header, data, sizeof(header));
+  return header == kTVMNDArrayListMagicV2;
+}
+
+std::vector<ParamEntry> LoadParamIndex(dmlc::Stream* strm) {
+  uint64_t header, reserved, sz;
+  CHECK(strm->Read(&header, sizeof(header)) == sizeof(header) &&
+        header == kTVMNDArrayListMagicV2)
+      << "Invalid parameters file format";
+  CHECK(strm->Read(&reserved, sizeof(reserved)) == sizeof(reserved))
+      << "Invalid parameters file format";
+  CHECK(strm->Read(&sz, sizeof(sz)) == sizeof(sz))
+      << "Invalid parameters file format";
+  std::vector<ParamEntry> index(static_cast<size_t>(sz));
+  for (ParamEntry& e : index) {
+    CHECK(e.Load(strm))
+        << "Invalid parameters file format";
+    CHECK(e.codec == kParamRaw ||
+          (e.codec == kParamFloat16 && IsFloat32(e.dtype)))
+        << "Invalid parameters file format, unknown codec of " << e.name;
+    CHECK_EQ(e.nbytes, GetStoredSize(e))
+        << "Invalid parameters file format, corrupted " << e.name;
+  }
+  return index;
+}
+
+std::vector<ParamEntry> LoadParamIndex(const void* data, size_t size) {
+  dmlc::MemoryFixedSizeStream strm(const_cast<void*>(data), size);
+  std::vector<ParamEntry> index = LoadParamIndex(&strm);
+  for (const ParamEntry& e : index) {
+    CHECK(e.offset <= size && e.nbytes <= size - e.offset)
+        << "Invalid parameters file format, truncated " << e.name;
+  }
+  return index;
+}
+
+DLTensor* AllocParamTensor(const ParamEntry& e) {
+  DLTensor* ret;
+  CHECK_EQ(TVMArrayAlloc(e.shape.data(),
+                         static_cast<int>(e.shape.size()),
+                         e.dtype.code,
+                         e.dtype.bits,
+                         e.dtype.lanes,
+                         kDLCPU, 0,
+                         &ret), 0) << TVMGetLastError();
+  return ret;
+}
+
+void DecodeParamPayload(const ParamEntry& e, const char* src, void* dst) {
+  if (e.codec == kParamFloat16) {
+    float* out = static_cast<float*>(dst);
+    size_t size = static_cast<size_t>(e.nbytes / sizeof(uint16_t));
+    for (size_t i = 0; i < size; ++i) {
+      uint16_t h;
+      std::memcpy(&h, src + i * sizeof(h), sizeof(h));
+      out[i] = HalfToFloat(h);
+    }
+  } else {
+    std::memcpy(dst, src, e.nbytes);
+  }
+}
+
+// Part of a payload read by one thread.
+struct ParamShard {
+  uint64_t offset;
+  uint64_t size;
+  char* dst;
+};
+
+// The largest shard, so a large tensor is read by several threads.
+constexpr uint64_t kParamShardSize = 16 << 20;
+
+inline void ReadParamShards(const std::string& path,
+                            const std::vector<ParamShard>& shards,
+                            int nthread) {
+  auto worker = [&path, &shards](size_t begin, size_t step, std::string* err) {
+    try {
+      std::unique_ptr<dmlc::SeekStream> fi(
+          dmlc::SeekStream::CreateForRead(path.c_str()));
+      for (size_t i = begin; i < shards.size(); i += step) {
+        fi->Seek(shards[i].offset);
+        CHECK_EQ(fi->Read(shards[i].dst, shards[i].size), shards[i].size)
+            << "Invalid parameters file format, truncated " << path;
+      }
+    } catch (const dmlc::Error& e) {
+      *err = e.what();
+    }
+  };
+  size_t nworker = std::min(static_cast<size_t>(std::max(nthread, 1)), shards.size());
+  std::vector<std::string> errors(nworker);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < nworker; ++i) {
+    threads.emplace_back(worker, i, nworker, &errors[i]);
+  }
+  if (nworker != 0) worker(0, nworker, &errors[0]);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (const std::string& err : errors) {
+    if (!err.empty()) LOG(FATAL) << err;
+  }
+}
+
+inline void AppendShards(const ParamEntry& e, void* dst,
+                         std::vector<ParamShard>* shards) {
+  char* ptr = static_cast<char*>(dst);
+  for (uint64_t begin = 0; begin < e.nbytes; begin += kParamShardSize) {
+    uint64_t size = std::min(kParamShardSize, e.nbytes - begin);
+    shards->push_back(ParamShard{e.offset + begin, size, ptr + begin});
+  }
+}
+
+void ReadParamPayloads(const std::string& path,
+                       const std::vector<ParamEntry>& index,
+                       const std::vector<DLTensor*>& arrays,
+                       int nthread) {
+  CHECK_EQ(index.size(), arrays.size());
+  std::vector<ParamShard> shards;
+  std::vector<size_t> staged;
+  for (size_t i = 0; i < index.size(); ++i) {
+    const ParamEntry& e = index[i];
+    const DLTensor* arr = arrays[i];
+    CHECK(arr->ndim == static_cast<int>(e.shape.size()) &&
+          std::equal(e.shape.begin(), e.shape.end(), arr->shape))
+        << "Shape mismatch of " << e.name;
+    CHECK(arr->dtype.code == e.dtype.code && arr->dtype.bits == e.dtype.bits &&
+          arr->dtype.lanes == e.dtype.lanes)
+        << "Type mismatch of " << e.name;
+    if (arr->ctx.device_type != kDLCPU || e.codec != kParamRaw) {
+      staged.push_back(i);
+    } else {
+      AppendShards(e, arr->data, &shards);
+    }
+  }
+  ReadParamShards(path, shards, nthread);
+  // encoded payloads and device arrays go through
+  // temporary cpu buffers, one tensor at a time.
+  for (size_t i : staged) {
+    const ParamEntry& e = index[i];
+    DLTensor* temp = nullptr;
+    void* dst = arrays[i]->data;
+    if (arrays[i]->ctx.device_type != kDLCPU) {
+      temp = AllocParamTensor(e);
+      dst = temp->data;
+    }
+    std::vector<ParamShard> temp_shards;
+    if (e.codec != kParamRaw) {
+      std::vector<char> buffer(static_cast<size_t>(e.nbytes));
+      AppendShards(e, buffer.data(), &temp_shards);
+      ReadParamShards(path, temp_shards, nthread);
+      DecodeParamPayload(e, buffer.data(), dst);
+    } else {
+      AppendShards(e, dst, &temp_shards);
+      ReadParamShards(path, temp_shards, nthread);
+    }
+    if (temp != nullptr) {
+      CHECK_EQ(TVMArrayCopyFromTo(temp, arrays[i], nullptr), 0) << TVMGetLastError();
+      CHECK_EQ(TVMArrayFree(temp), 0) << TVMGetLastError();
+    }
+  }
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+  std::ifstream fs(path, std::ios::in | std::ios::binary);
+  CHECK(!fs.fail()) << "Cannot open " << path;
+  buffer_.assign(std::istreambuf_iterator<char>(fs),
+                 std::istreambuf_iterator<char>());
+  data_ = &buffer_[0];
+  size_ = buffer_.length();
+}
+
+MappedFile::~MappedFile() {}
+#else
+MappedFile::MappedFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_NE(fd, -1) << "Cannot open " << path;
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << path;
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ != 0) {
+    // private mapping, the pages are only read from disk when touched.
+    void* ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    CHECK(ptr != MAP_FAILED) << "Cannot mmap " << path;
+    data_ = static_cast<char*>(ptr);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) munmap(data_, size_);
+}
+#endif
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._save_param_file")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    // path, followed by name, array and codec of each parameter
+    CHECK_EQ(args.size() % 3, 1);
+    std::string path = args[0];
+    size_t num_params = args.size() / 3;
+    std::vector<std::string> names;
+    names.reserve(num_params);
+    std::vector<DLTensor*> arrays;
+    arrays.reserve(num_params);
+    std::vector<uint32_t> codecs;
+    codecs.reserve(num_params);
+    for (int i = 1; i < args.size(); i += 3) {
+      names.emplace_back(args[i].operator std::string());
+      arrays.emplace_back(args[i + 1].operator DLTensor*());
+      codecs.emplace_back(static_cast<uint32_t>(args[i + 2].operator int()));
+    }
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(path.c_str(), "w"));
+    SaveParamFile(fo.get(), names, arrays, codecs);
+  });
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._load_param_file_stream")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    std::string path = args[0];
+    int nthread = args[1];
+    std::vector<std::string> names;
+    std::vector<DLTensor*> data;
+    std::unique_ptr<dmlc::SeekStream> fi(
+        dmlc::SeekStream::CreateForRead(path.c_str()));
+    uint64_t header;
+    CHECK_EQ(fi->Read(&header, sizeof(header)), sizeof(header))
+        << "Invalid parameters file format";
+    fi->Seek(0);
+    if (header == kTVMNDArrayListMagicV2) {
+      std::vector<ParamEntry> index = LoadParamIndex(fi.get());
+      fi.reset();
+      for (const ParamEntry& e : index) {
+        names.push_back(e.name);
+        data.push_back(AllocParamTensor(e));
+      }
+      ReadParamPayloads(path, index, data, nthread);
+    } else {
+      // the payloads of the list format are not indexed, read one by one.
+      LoadNDArrayList(fi.get(), &names, &data);
+    }
+    *rv = ParamListFunction(names, data);
+  });
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._load_param_file_into")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    std::string path = args[0];
+    int nthread = args[1];
+    std::unordered_map<std::string, DLTensor*> dst;
+    for (int i = 2; i < args.size(); i += 2) {
+      dst[args[i].operator std::string()] = args[i + 1].operator DLTensor*();
+    }
+    std::vector<ParamEntry> index;
+    {
+      std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(path.c_str(), "r"));
+      index = LoadParamIndex(fi.get());
+    }
+    std::vector<ParamEntry> entries;
+    std::vector<DLTensor*> arrays;
+    for (const ParamEntry& e : index) {
+      auto it = dst.find(e.name);
+      if (it == dst.end()) continue;
+      entries.push_back(e);
+      arrays.push_back(it->second);
+      dst.erase(it);
+    }
+    CHECK(dst.empty())
+        << "Cannot find " << dst.begin()->first << " in " << path;
+    ReadParamPayloads(path, entries, arrays, nthread);
+  });
+
+PackedFunc MappedParamFunction(std::shared_ptr<MappedFile> file,
+                               size_t offset,
+                               size_t size) {
+  CHECK_LE(offset, file->size());
+  CHECK_LE(size, file->size() - offset);
+  char* base = file->data() + offset;
+  auto entries = std::make_shared<std::vector<ParamEntry> >(
+      LoadParamIndex(base, size));
+  // the tensors point into the mapping, which lives as long as the function.
+  // duplicated tensors share the payload, encoded tensors are decoded.
+  auto data = std::make_shared<std::vector<DLTensor> >(entries->size());
+  auto decoded = std::make_shared<std::vector<std::unique_ptr<float[]> > >();
+  for (size_t i = 0; i < entries->size(); ++i) {
+    ParamEntry& e = (*entries)[i];
+    DLTensor& tensor = (*data)[i];
+    tensor.data = base + e.offset;
+    if (e.codec != kParamRaw) {
+      size_t num_elems = static_cast<size_t>(e.nbytes / sizeof(uint16_t));
+      decoded->emplace_back(new float[num_elems]);
+      DecodeParamPayload(e, base + e.offset, decoded->back().get());
+      tensor.data = decoded->back().get();
+    }
+    tensor.ctx = DLContext{kDLCPU, 0};
+    tensor.ndim = static_cast<int>(e.shape.size());
+    tensor.dtype = e.dtype;
+    tensor.shape = e.shape.data();
+    tensor.strides = nullptr;
+    tensor.byte_offset = 0;
+  }
+  auto packed = [file, entries, data, decoded](TVMArgs args, TVMRetValue* rv) {
+    int code = args[0];
+    if (code == 0) {
+      *rv = static_cast<int64_t>(data->size());
+    } else if (code == 1) {
+      int index = args[1];
+      *rv = (*entries)[index].name;
+    } else {
+      CHECK_EQ(code, 2);
+      int index = args[1];
+      *rv = static_cast<void*>(&(*data)[index]);
+    }
+  };
+  return PackedFunc(packed);
+}
+
+TVM_REGISTER_GLOBAL("nnvm.compiler._load_param_file")
+.set_body([](TVMArgs args, TVMRetValue *rv) {
+    std::string path = args[0];
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+    *rv = MappedParamFunction(file, 0, file->size());
+  });
+
+}  // namespace compiler
+}  // namespace nnvm
@@ -0,0 +1,167 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file param_file.h
+ * \brief Aligned parameter file format that can be memory mapped.
+ *
+ *  The file starts with a header and an index of the tensors
+ *
+ *    uint64_t magic, reserved, num_tensors
+ *    ParamEntry index[num_tensors]
+ *
+ *  The payload of each tensor is stored at ParamEntry::offset,
+ *  which is aligned to kParamFileAlign, so the tensors can
+ *  point into a mapping of the file directly.
+*/
+#ifndef NNVM_COMPILER_PARAM_FILE_H_
+#define NNVM_COMPILER_PARAM_FILE_H_
+
+#include <dmlc/io.h>
+#include <dlpack/dlpack.h>
+#include <tvm/runtime/packed_func.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nnvm {
+namespace compiler {
+
+/*! \brief Magic number for aligned NDArray list file */
+constexpr uint64_t kTVMNDArrayListMagicV2 = 0xF7E58D4F05049CB8;
+/*! \brief Alignment of the tensor payloads in the file */
+constexpr uint64_t kParamFileAlign = 4096;
+
+/*! \brief Storage codec of a tensor payload. */
+enum ParamCodec : uint32_t {
+  /*! \brief the payload is the tensor data */
+  kParamRaw = 0,
+  /*! \brief float32 tensor stored as float16, upcast on load */
+  kParamFloat16 = 1
+};
+
+/*!
+ * \brief Index entry of a tensor in the parameter file.
+ *  Entries with the same stored payload share the offset.
+ */
+struct ParamEntry {
+  /*! \brief name of the parameter */
+  std::string name;
+  /*! \brief data type of the tensor */
+  DLDataType dtype;
+  /*! \brief shape of the tensor */
+  std::vector<int64_t> shape;
+  /*! \brief storage codec of the payload, see ParamCodec */
+  uint32_t codec{kParamRaw};
+  /*! \brief offset of the payload from the start of the file */
+  uint64_t offset{0};
+  /*! \brief number of bytes of the stored payload */
+  uint64_t nbytes{0};
+
+  void Save(dmlc::Stream* strm) const;
+  bool Load(dmlc::Stream* strm);
+};
+
+/*!
+ * \brief Save cpu tensors in the aligned format.
+ *  Tensors with identical stored payload are stored once.
+ * \param strm The output stream.
+ * \param names The names of the tensors.
+ * \param arrays The tensors to be saved.
+ * \param codecs The storage codec of each tensor, raw if empty.
+ * \return The number of bytes written.
+ */
+uint64_t SaveParamFile(dmlc::Stream* strm,
+                   const std::vector<std::string>& names,
+                   const std::vector<DLTensor*>& arrays,
+                   const std::vector<uint32_t>& codecs = {});
+
+/*!
+ * \brief Check whether the buffer starts with the aligned format header.
+ * \param data The buffer.
+ * \param size The size of the buffer.
+ */
+bool IsParamFile(const void* data, size_t size);
+
+/*!
+ * \brief Read the header and the index of a parameter file.
+ * \param strm The input stream at the start of the file.
+ * \return The index of the tensors.
+ */
+std::vector<ParamEntry> LoadParamIndex(dmlc::Stream* strm);
+
+/*!
+ * \brief Read the index of a parameter file in memory.
+ *  The payload offsets are checked against the buffer size.
+ * \param data The start of the file in memory.
+ * \param size The size of the file.
+ * \return The index of the tensors.
+ */
+std::vector<ParamEntry> LoadParamIndex(const void* data, size_t size);
+
+/*!
+ * \brief Allocate a cpu array matching the entry.
+ * \param e The index entry.
+ * \return The new array, to be freed by the caller.
+ */
+DLTensor* AllocParamTensor(const ParamEntry& e);
+
+/*!
+ * \brief Decode the stored payload of an entry.
+ * \param e The index entry.
+ * \param src The stored payload.
+ * \param dst The cpu destination of the tensor data.
+ */
+void DecodeParamPayload(const ParamEntry& e, const char* src, void* dst);
+
+/*!
+ * \brief Read the payloads of a parameter file into existing arrays.
+ *  Large payloads are split into shards, read by nthread threads
+ *  with one stream per thread, so the peak memory of loading is
+ *  the size of the arrays.
+ * \param path The path to the file.
+ * \param index The entries to be read.
+ * \param arrays The destination of each entry, of matching shape and type.
+ *  Arrays not on cpu are copied through a temporary cpu array.
+ * \param nthread The number of threads.
+ */
+void ReadParamPayloads(const std::string& path,
+                       const std::vector<ParamEntry>& index,
+                       const std::vector<DLTensor*>& arrays,
+                       int nthread);
+
+/*!
+ * \brief Read only, private mapping of a file.
+ *  Writes to the mapping are copy on write and never reach the file.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  /*! \return the start of the mapping */
+  char* data() const { return data_; }
+  /*! \return the size of the file */
+  size_t size() const { return size_; }
+
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+  /*! \brief file content when mmap is not available */
+  std::string buffer_;
+};
+
+/*!
+ * \brief Get the function to access the tensors of a mapped parameter file,
+ *  in the same convention as ParamListFunction. The tensors point into
+ *  the mapping, which is kept alive by the function.
+ * \param file The mapped file.
+ * \param offset The offset of the parameter file in the mapping.
+ * \param size The size of the parameter file.
+ */
+tvm::runtime::PackedFunc MappedParamFunction(std::shared_ptr<MappedFile> file,
+                                             size_t offset,
+                                             size_t size);
+
+}  // namespace compiler
+}  // namespace nnvm
+#endif   // NNVM_COMPILER_PARAM_FILE_H_
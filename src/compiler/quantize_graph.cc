@@ -0,0 +1,145 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file quantize_graph.cc
+ * \brief Rewrite conv2d and dense into int8 operands with int32
+ *  accumulation, given the calibrated range of their data input.
+ */
+#include <nnvm/graph.h>
+#include <nnvm/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <nnvm/pass.h>
+#include <nnvm/compiler/op_attr_types.h>
+#include <nnvm/top/nn.h>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include "./graph_transform.h"
+#include "./pattern_util.h"
+
+namespace nnvm {
+namespace compiler {
+
+// The calibrated maximum absolute value of the data input,
+// indexed by the name of the quantized operator.
+using QuantizeRangeMap = std::unordered_map<std::string, double>;
+
+// The largest value of symmetric int8 quantization.
+constexpr double kInt8Range = 127.0;
+
+inline std::string ScalarString(double value) {
+  std::ostringstream os;
+  os.precision(17);
+  os << value;
+  return os.str();
+}
+
+/*!
+ * \brief Quantize the weight per output channel (axis 0).
+ *  The subgraph only depends on the weight, so it is folded
+ *  into int8 parameters by PrecomputePrune.
+ * \param weight The float weight.
+ * \param ndim The number of dimensions of the weight.
+ * \param name The name prefix of the created nodes.
+ * \param scale The scale of each output channel.
+ * \return The int8 weight.
+ */
+NodeEntry QuantizeWeight(const NodeEntry& weight,
+                         int ndim,
+                         const std::string& name,
+                         NodeEntry* scale) {
+  // the absolute max of each channel is sqrt(max(w * w)).
+  TShape axis = {0};
+  std::ostringstream axis_os; axis_os << axis;
+  NodeEntry sqr = MakeNode("elemwise_mul", name + "_sqr", {weight, weight});
+  NodeEntry amax = MakeNode("max", name + "_max", {sqr},
+                            {{"axis", axis_os.str()}, {"exclude", "true"}});
+  // avoid zero scale of an all zero channel
+  amax = MakeNode("__add_scalar__", name + "_eps", {amax},
+                  {{"scalar", ScalarString(1e-12)}});
+  amax = MakeNode("sqrt", name + "_amax", {amax});
+  *scale = MakeNode("__div_scalar__", name + "_scale", {amax},
+                    {{"scalar", ScalarString(kInt8Range)}});
+  NodeEntry w = MakeNode("broadcast_div", name + "_div",
+                         {weight, ExpandBiasToMatchAxis(*scale, ndim, 1, 0)});
+  return MakeNode("quantize", name + "_q", {w});
+}
+
+Graph QuantizeGraph(Graph src) {
+  const QuantizeRangeMap& range =
+      src.GetAttr<QuantizeRangeMap>("quantize_range");
+  static const Op* conv2d = Op::Get("conv2d");
+  static const Op* dense = Op::Get("dense");
+  // quantized data shared by the consumers of the same entry.
+  NodeEntryMap<NodeEntry> qdata_map;
+
+  auto transform = [&](uint32_t nid, const NodePtr& n, std::vector<NodeEntry>* ret) {
+    if (n->is_variable()) return false;
+    if (n->op() != conv2d && n->op() != dense) return false;
+    auto it = range.find(n->attrs.name);
+    if (it == range.end() || it->second <= 0) return false;
+    bool is_conv = n->op() == conv2d;
+    bool use_bias;
+    if (is_conv) {
+      const auto& param = nnvm::get<top::Conv2DParam>(n->attrs.parsed);
+      // the weight is quantized per output channel of NCHW weight.
+      if (param.layout != top::kNCHW || param.groups != 1 ||
+          param.out_dtype != -1) {
+        return false;
+      }
+      use_bias = param.use_bias;
+    } else {
+      const auto& param = nnvm::get<top::DenseParam>(n->attrs.parsed);
+      if (param.out_dtype != -1) return false;
+      use_bias = param.use_bias;
+    }
+    const std::string& name = n->attrs.name;
+    double data_scale = it->second / kInt8Range;
+    const NodeEntry& data = n->inputs[0];
+    if (!qdata_map.count(data)) {
+      qdata_map[data] = MakeNode(
+          "quantize", name + "_data_q", {data},
+          {{"scale", ScalarString(data_scale)}});
+    }
+    NodeEntry weight_scale;
+    NodeEntry qweight = QuantizeWeight(
+        n->inputs[1], is_conv ? 4 : 2, name + "_weight", &weight_scale);
+    // int8 operands with int32 accumulation
+    std::unordered_map<std::string, std::string> kwargs = n->attrs.dict;
+    kwargs["use_bias"] = "false";
+    kwargs["out_dtype"] = "int32";
+    NodeEntry out = MakeNode(n->op()->name.c_str(), name,
+                             {qdata_map.at(data), qweight}, kwargs);
+    // dequantize, one step of output is data_scale * weight_scale,
+    // the elementwise tail is fused into the int32 compute.
+    NodeEntry out_scale = MakeNode(
+        "__mul_scalar__", name + "_out_scale", {weight_scale},
+        {{"scalar", ScalarString(data_scale)}});
+    if (is_conv) {
+      out_scale = ExpandBiasToMatchAxis(out_scale, 4, 1, 1);
+    }
+    out = MakeNode("cast", name + "_dq", {out}, {{"dtype", "float32"}});
+    out = MakeNode("broadcast_mul", name + "_rescale", {out, out_scale});
+    if (use_bias) {
+      NodeEntry bias = n->inputs[2];
+      if (is_conv) {
+        bias = ExpandBiasToMatchAxis(bias, 4, 1, 1);
+      }
+      out = MakeNode("broadcast_add", name + "_bias", {out, bias});
+    }
+    *ret = {out};
+    return true;
+  };
+  return GraphTransform(src, transform);
+}
+
+NNVM_REGISTER_PASS(QuantizeGraph)
+.describe("Rewrite conv2d and dense into int8 compute with int32 accumulation "\
+          "given the calibrated range of their data input.")
+.set_body(QuantizeGraph)
+.set_change_graph(true)
+.depend_graph_attr("quantize_range");
+
+DMLC_JSON_ENABLE_ANY(QuantizeRangeMap, dict_str_float);
+
+}  // namespace compiler
+}  // namespace nnvm
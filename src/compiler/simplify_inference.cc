@@ -97,11 +97,18 @@ Graph SimplifyInference(nnvm::Graph src) {
       return false;
     }
   };
-  return GraphTransform(src, transform);
+  GraphDelta delta;
+  Graph ret = GraphTransform(src, transform, &delta);
+  // the replaced entries keep their shape and type.
+  CarryOverEntryAttr<TShape>(src, delta, "shape", TShape(), &ret);
+  CarryOverEntryAttr<int>(src, delta, "dtype", -1, &ret);
+  return ret;
 }
 
 NNVM_REGISTER_PASS(SimplifyInference)
-.set_body(SimplifyInference);
+.set_body(SimplifyInference)
+.set_change_graph(true)
+.depend_graph_attr("shape");
 
 }  // namespace compiler
 }  // namespace nnvm
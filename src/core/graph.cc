@@ -16,6 +16,35 @@ const IndexedGraph& Graph::indexed_graph() const {
   return *indexed_graph_;
 }
 
+constexpr uint32_t NodeIndexMap::kNotFound;
+
+void NodeIndexMap::Insert(const nnvm::Node* node, uint32_t nid) {
+  CHECK(node != nullptr) << "Cannot insert nullptr";
+  // keep the load factor at most one half
+  if ((size_ + 1) * 2 > slots_.size()) {
+    Rehash(std::max<size_t>(slots_.size() * 2, 16));
+  }
+  size_t i = Hash(node) & mask_;
+  while (slots_[i].node != nullptr) {
+    CHECK(slots_[i].node != node) << "Node is inserted twice";
+    i = (i + 1) & mask_;
+  }
+  slots_[i] = Slot{node, nid};
+  ++size_;
+}
+
+void NodeIndexMap::Rehash(size_t capacity) {
+  std::vector<Slot> old(capacity, Slot{nullptr, 0});
+  old.swap(slots_);
+  mask_ = capacity - 1;
+  for (const Slot& s : old) {
+    if (s.node == nullptr) continue;
+    size_t i = Hash(s.node) & mask_;
+    while (slots_[i].node != nullptr) i = (i + 1) & mask_;
+    slots_[i] = s;
+  }
+}
+
 // implement constructor from graph
 IndexedGraph::IndexedGraph(const Graph &g) {
   entry_rptr_.push_back(0);
@@ -35,28 +64,28 @@ IndexedGraph::IndexedGraph(const Graph &g) {
         input_nodes_.push_back(nid);
       }
       // node2index_
-      node2index_[n.get()] = nid;
+      node2index_.Insert(n.get(), nid);
       // entry rptr
       entry_rptr_.push_back(entry_rptr_.back() + n->num_outputs());
       // input entries
       for (const auto& e : n->inputs) {
-        auto it = node2index_.find(e.node.get());
-        CHECK(it != node2index_.end() && it->first == e.node.get());
-        input_entries_.emplace_back(NodeEntry{it->second, e.index, e.version});
+        uint32_t input_id = node2index_.Find(e.node.get());
+        CHECK_NE(input_id, NodeIndexMap::kNotFound);
+        input_entries_.emplace_back(NodeEntry{input_id, e.index, e.version});
       }
       inputs_rptr.push_back(input_entries_.size());
       // control deps
       for (const auto& nptr : n->control_deps) {
-        auto it = node2index_.find(nptr.get());
-        CHECK(it != node2index_.end() && it->first == nptr.get());
-        control_deps_.push_back(it->second);
+        uint32_t dep_id = node2index_.Find(nptr.get());
+        CHECK_NE(dep_id, NodeIndexMap::kNotFound);
+        control_deps_.push_back(dep_id);
       }
       control_rptr.push_back(control_deps_.size());
   });
 
   for (const auto& e : g.outputs) {
     outputs_.emplace_back(NodeEntry{
-        node2index_.at(e.node.get()), e.index, e.version});
+        node_id(e.node.get()), e.index, e.version});
   }
 
   static auto& fmutate_inputs = Op::GetAttr<FMutateInputs>("FMutateInputs");
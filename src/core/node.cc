@@ -3,10 +3,133 @@
  * \file node.cc
  * \brief Graph node data structure.
  */
+#include <dmlc/thread_local.h>
 #include <nnvm/node.h>
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
 
 namespace nnvm {
 
+/*! \brief Number of nodes in the first page of an arena. */
+constexpr size_t kNodeArenaMinPageSize = 16;
+/*! \brief Number of nodes in the largest page of an arena. */
+constexpr size_t kNodeArenaMaxPageSize = 1024;
+
+/*!
+ * \brief Pool of fixed size blocks, holding the nodes together with
+ *  their shared_ptr control blocks. Freed blocks are kept in a free list
+ *  and reused; the pages are released when the arena is destroyed.
+ *  The pages double in size, so that small graphs do not pin a large page.
+ */
+class NodeArena {
+ public:
+  /*!
+   * \brief allocate memory of size bytes.
+   *  Requests of other sizes than the first one go to operator new.
+   */
+  void* Alloc(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (block_size_ == 0) {
+      block_size_ = RoundUp(std::max(size, sizeof(FreeBlock)));
+      request_size_ = size;
+    }
+    if (size != request_size_) return ::operator new(size);
+    if (free_ == nullptr) {
+      const size_t num_blocks = page_size_;
+      page_size_ = std::min(page_size_ * 2, kNodeArenaMaxPageSize);
+      pages_.emplace_back(new char[block_size_ * num_blocks]);
+      char* page = pages_.back().get();
+      // thread the new blocks in address order
+      for (size_t i = num_blocks; i != 0; --i) {
+        FreeBlock* b = reinterpret_cast<FreeBlock*>(page + (i - 1) * block_size_);
+        b->next = free_;
+        free_ = b;
+      }
+    }
+    FreeBlock* b = free_;
+    free_ = b->next;
+    return b;
+  }
+  /*! \brief free memory from Alloc(size) */
+  void Free(void* ptr, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size != request_size_) {
+      ::operator delete(ptr);
+      return;
+    }
+    FreeBlock* b = static_cast<FreeBlock*>(ptr);
+    b->next = free_;
+    free_ = b;
+  }
+
+ private:
+  /*! \brief link of a free block */
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  /*! \return size rounded up to the maximum alignment */
+  static size_t RoundUp(size_t size) {
+    const size_t align = alignof(std::max_align_t);
+    return (size + align - 1) / align * align;
+  }
+  std::mutex mutex_;
+  size_t block_size_{0};
+  size_t request_size_{0};
+  size_t page_size_{kNodeArenaMinPageSize};
+  FreeBlock* free_{nullptr};
+  std::vector<std::unique_ptr<char[]> > pages_;
+};
+
+/*!
+ * \brief Allocator for std::allocate_shared from a node arena.
+ *  It holds a reference to the arena, which lives in the control block
+ *  of each node allocated from it.
+ */
+template<typename T>
+struct NodeArenaAllocator {
+  using value_type = T;
+  std::shared_ptr<NodeArena> arena;
+
+  explicit NodeArenaAllocator(std::shared_ptr<NodeArena> arena)
+      : arena(std::move(arena)) {}
+  template<typename U>
+  NodeArenaAllocator(const NodeArenaAllocator<U>& other)  // NOLINT(*)
+      : arena(other.arena) {}
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena->Alloc(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t n) {
+    arena->Free(p, n * sizeof(T));
+  }
+  template<typename U>
+  bool operator==(const NodeArenaAllocator<U>& other) const {
+    return arena == other.arena;
+  }
+  template<typename U>
+  bool operator!=(const NodeArenaAllocator<U>& other) const {
+    return arena != other.arena;
+  }
+};
+
+/*! \brief The arena of the innermost scope of a thread. */
+struct NodeArenaEntry {
+  std::shared_ptr<NodeArena> arena;
+};
+
+typedef dmlc::ThreadLocalStore<NodeArenaEntry> NodeArenaStore;
+
+NodeArenaScope::NodeArenaScope() {
+  NodeArenaEntry* e = NodeArenaStore::Get();
+  prev_ = std::move(e->arena);
+  e->arena = std::make_shared<NodeArena>();
+}
+
+NodeArenaScope::~NodeArenaScope() {
+  NodeArenaStore::Get()->arena = std::move(prev_);
+}
+
 Node::~Node() {
   if (inputs.size() != 0) {
     // explicit deletion via DFS
@@ -38,6 +161,14 @@ Node::~Node() {
 }
 
 NodePtr Node::Create() {
+  const std::shared_ptr<NodeArena>& arena = NodeArenaStore::Get()->arena;
+  if (arena != nullptr) {
+    return std::allocate_shared<Node>(NodeArenaAllocator<Node>(arena));
+  }
+  return std::make_shared<Node>();
+}
+
+NodePtr Node::CreateVariable() {
   return std::make_shared<Node>();
 }
 
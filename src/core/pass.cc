@@ -4,7 +4,17 @@
  * \brief Support for pass registry.
  */
 #include <nnvm/pass.h>
+#include <nnvm/graph_attr_types.h>
+#include <dmlc/json.h>
+#include <dmlc/thread_local.h>
+#include <dmlc/timer.h>
 #include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 namespace dmlc {
 // enable registry
@@ -22,20 +32,125 @@ const PassFunctionReg* FindPassDep(const std::string&attr_name) {
   return nullptr;
 }
 
-Graph ApplyPasses(Graph g,
-                  const std::vector<std::string>& pass) {
-  std::vector<const PassFunctionReg*> fpass;
-  for (auto& name : pass) {
-    auto* reg = dmlc::Registry<PassFunctionReg>::Find(name);
-    CHECK(reg != nullptr)
-        << "Cannot find pass " << name << " in the registry";
-    fpass.push_back(reg);
+void PassProfileEntry::Save(dmlc::JSONWriter* writer) const {
+  writer->BeginObject();
+  writer->WriteObjectKeyValue("name", name);
+  writer->WriteObjectKeyValue("time_ms", time_ms);
+  writer->WriteObjectKeyValue("num_nodes_before", num_nodes_before);
+  writer->WriteObjectKeyValue("num_nodes_after", num_nodes_after);
+  writer->WriteObjectKeyValue("num_entries_before", num_entries_before);
+  writer->WriteObjectKeyValue("num_entries_after", num_entries_after);
+  writer->WriteObjectKeyValue("allocated_bytes", allocated_bytes);
+  writer->EndObject();
+}
+
+void PassProfileEntry::Load(dmlc::JSONReader* reader) {
+  dmlc::JSONObjectReadHelper helper;
+  helper.DeclareField("name", &name);
+  helper.DeclareOptionalField("time_ms", &time_ms);
+  helper.DeclareOptionalField("num_nodes_before", &num_nodes_before);
+  helper.DeclareOptionalField("num_nodes_after", &num_nodes_after);
+  helper.DeclareOptionalField("num_entries_before", &num_entries_before);
+  helper.DeclareOptionalField("num_entries_after", &num_entries_after);
+  helper.DeclareOptionalField("allocated_bytes", &allocated_bytes);
+  helper.ReadAllFields(reader);
+}
+
+DMLC_JSON_ENABLE_ANY(PassProfile, list_pass_profile);
+
+namespace {
+
+/*! \return the heap bytes in use, zero if the allocator cannot tell */
+int64_t HeapBytesInUse() {
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+  struct mallinfo2 info = mallinfo2();
+  return static_cast<int64_t>(info.uordblks + info.hblkhd);
+#else
+  struct mallinfo info = mallinfo();
+  return static_cast<int64_t>(static_cast<unsigned>(info.uordblks)) +
+      static_cast<int64_t>(static_cast<unsigned>(info.hblkhd));
+#endif
+#else
+  return 0;
+#endif
+}
+
+/*! \brief The phases of the pass running on a thread, nullptr if not profiled. */
+struct PassPhaseSink {
+  PassProfile* phases{nullptr};
+};
+
+typedef dmlc::ThreadLocalStore<PassPhaseSink> PassPhaseStore;
+
+/*! \brief Set the phase sink of the thread while in scope. */
+class PassPhaseScope {
+ public:
+  explicit PassPhaseScope(PassProfile* phases) {
+    PassPhaseSink* sink = PassPhaseStore::Get();
+    prev_ = sink->phases;
+    sink->phases = phases;
+  }
+  ~PassPhaseScope() {
+    PassPhaseStore::Get()->phases = prev_;
   }
 
-  for (auto r : fpass) {
+ private:
+  PassProfile* prev_;
+};
+
+}  // namespace
+
+PassPhaseProfiler::PassPhaseProfiler(std::string name)
+    : name_(std::move(name)) {
+  phases_ = PassPhaseStore::Get()->phases;
+  if (phases_ == nullptr) return;
+  start_bytes_ = HeapBytesInUse();
+  start_time_ = dmlc::GetTime();
+}
+
+PassPhaseProfiler::~PassPhaseProfiler() {
+  if (phases_ == nullptr) return;
+  PassProfileEntry e;
+  e.name = name_;
+  e.time_ms = (dmlc::GetTime() - start_time_) * 1000;
+  e.allocated_bytes = HeapBytesInUse() - start_bytes_;
+  phases_->emplace_back(std::move(e));
+}
+
+namespace {
+
+/*! \brief Applies passes, resolving the dependencies of each pass. */
+class PassManager {
+ public:
+  PassManager(Graph g, bool profile) : g_(std::move(g)) {
+    // the profile of an earlier call is not carried over.
+    g_.attrs.erase("pass_profile");
+    if (profile) profile_ = std::make_shared<any>(PassProfile());
+  }
+
+  /*!
+   * \brief apply a pass after the passes providing its dependencies.
+   * \param r The pass.
+   */
+  void Apply(const PassFunctionReg* r) {
+    if (!r->change_graph && !r->graph_attr_targets.empty() &&
+        applied_.count(r) != 0 && !HasPendingInputs(r)) {
+      // same result as the last run.
+      return;
+    }
+    CHECK(!resolving_.count(r))
+        << "Cyclic graph attr dependency on pass " << r->name;
+    resolving_.insert(r);
     for (auto& dep : r->graph_attr_dependency) {
-      if (g.attrs.count(dep) == 0) {
-        auto* pass_dep = FindPassDep(dep);
+      if (g_.attrs.count(dep) != 0 && g_.attrs.count(dep + "_inputs") == 0) {
+        continue;
+      }
+      const PassFunctionReg* pass_dep = FindPassDep(dep);
+      if (pass_dep != nullptr && !resolving_.count(pass_dep)) {
+        this->Apply(pass_dep);
+      }
+      if (g_.attrs.count(dep) == 0) {
         std::string msg;
         if (pass_dep != nullptr) {
           msg = " The attribute is provided by pass " + pass_dep->name;
@@ -46,10 +161,84 @@ Graph ApplyPasses(Graph g,
                    << msg;
       }
     }
-    g = r->body(std::move(g));
+    resolving_.erase(r);
+    if (profile_ != nullptr) {
+      this->ProfiledApply(r);
+    } else {
+      // passes applied inside the pass are not profiled either.
+      PassPhaseScope scope(nullptr);
+      g_ = r->body(std::move(g_));
+    }
+    if (r->change_graph) applied_.clear();
+    applied_.insert(r);
+  }
+  /*! \return the transformed graph */
+  Graph Finish() {
+    if (profile_ != nullptr) {
+      g_.attrs["pass_profile"] = profile_;
+    }
+    return std::move(g_);
+  }
+
+ private:
+  /*! \brief apply a pass and record its profile */
+  void ProfiledApply(const PassFunctionReg* r) {
+    PassProfileEntry e;
+    e.name = r->name;
+    e.num_nodes_before = g_.indexed_graph().num_nodes();
+    e.num_entries_before = g_.indexed_graph().num_node_entries();
+    // collects the phases recorded by PassPhaseProfiler in the pass.
+    PassProfile phases;
+    int64_t start_bytes = HeapBytesInUse();
+    double start_time = dmlc::GetTime();
+    {
+      PassPhaseScope scope(&phases);
+      g_ = r->body(std::move(g_));
+    }
+    e.time_ms = (dmlc::GetTime() - start_time) * 1000;
+    e.allocated_bytes = HeapBytesInUse() - start_bytes;
+    e.num_nodes_after = g_.indexed_graph().num_nodes();
+    e.num_entries_after = g_.indexed_graph().num_node_entries();
+    PassProfile& profile = nnvm::get<PassProfile>(*profile_);
+    profile.emplace_back(std::move(e));
+    for (PassProfileEntry& phase : phases) {
+      profile.emplace_back(std::move(phase));
+    }
+  }
+  /*! \return whether inputs of the attributes of r are pending */
+  bool HasPendingInputs(const PassFunctionReg* r) const {
+    for (auto& s : r->graph_attr_targets) {
+      if (g_.attrs.count(s) == 0 || g_.attrs.count(s + "_inputs") != 0) return true;
+    }
+    return false;
   }
+  // the current graph
+  Graph g_;
+  // passes applied since the last change of structure
+  std::unordered_set<const PassFunctionReg*> applied_;
+  // passes whose dependencies are being resolved
+  std::unordered_set<const PassFunctionReg*> resolving_;
+  // the profile of the applied passes, nullptr if not profiling
+  std::shared_ptr<any> profile_;
+};
 
-  return g;
+}  // namespace
+
+Graph ApplyPasses(Graph g,
+                  const std::vector<std::string>& pass,
+                  bool profile) {
+  std::vector<const PassFunctionReg*> fpass;
+  for (auto& name : pass) {
+    auto* reg = dmlc::Registry<PassFunctionReg>::Find(name);
+    CHECK(reg != nullptr)
+        << "Cannot find pass " << name << " in the registry";
+    fpass.push_back(reg);
+  }
+  PassManager manager(std::move(g), profile);
+  for (auto r : fpass) {
+    manager.Apply(r);
+  }
+  return manager.Finish();
 }
 
 }  // namespace nnvm
@@ -19,7 +19,7 @@ struct VariableParam {
 };
 
 NodePtr CreateVariableNode(const std::string& name) {
-  NodePtr n = Node::Create();
+  NodePtr n = Node::CreateVariable();
   n->attrs.op = nullptr;
   n->attrs.name = name;
   n->attrs.parsed = VariableParam();
@@ -96,10 +96,12 @@ inline bool IsAtomic(const std::vector<NodeEntry>& outputs) {
 
 // public functions
 Symbol Symbol::Copy() const {
+  // the copied nodes share one arena.
+  NodeArenaScope arena_scope;
   std::unordered_map<Node*, NodePtr> old_new;
   // use DFSVisit to copy all the nodes
   DFSVisit(this->outputs, [&old_new](const NodePtr& node) {
-      NodePtr np = Node::Create();
+      NodePtr np = node->is_variable() ? Node::CreateVariable() : Node::Create();
       np->attrs = node->attrs;
       old_new[node.get()] = std::move(np);
     });
@@ -73,6 +73,8 @@ Graph Gradient(Graph src) {
       << "Gradient require grad_ys_out_grad to be presented.";
   CHECK_NE(src.attrs.count("grad_xs"), 0U)
       << "Gradient require grad_xs to be presented.";
+  // the gradient nodes share one arena.
+  NodeArenaScope arena_scope;
   const std::vector<NodeEntry>& ys =
       src.GetAttr<std::vector<NodeEntry> >("grad_ys");
   const std::vector<NodeEntry>& ys_out_grad =
@@ -32,16 +32,35 @@ Graph InferAttr(Graph &&ret,
       Op::GetAttr<FGradient>("FGradient");
   // reshape shape vector
   AttrVector rshape;
+  // values carried over by a graph transform, see CarryOverEntryAttr.
+  std::string seed_key = std::string(attr_name) + "_seed";
+  bool seeded = false;
   if (ret.attrs.count(attr_name) != 0) {
     rshape = ret.MoveCopyAttr<AttrVector>(attr_name);
+    seeded = true;
+  } else if (ret.attrs.count(seed_key) != 0) {
+    rshape = ret.MoveCopyAttr<AttrVector>(seed_key);
+    // a seed that does not match the graph is discarded.
+    seeded = rshape.size() == idx.num_node_entries();
+    if (!seeded) rshape.assign(idx.num_node_entries(), empty_val);
   } else {
     rshape.resize(idx.num_node_entries(), empty_val);
   }
+  ret.attrs.erase(seed_key);
 
   if (ret.attrs.count(input_name) != 0) {
     const AttrVector& shape_args = ret.GetAttr<AttrVector>(input_name);
     CHECK_LE(shape_args.size(), idx.input_nodes().size())
         << "More provided shapes than number of arguments.";
+    // the previous values are no longer valid when the inputs changed.
+    for (size_t i = 0; seeded && i < shape_args.size(); ++i) {
+      const AttrType& seed_val = rshape[idx.entry_id(idx.input_nodes()[i], 0)];
+      if (!fis_none(shape_args[i]) && !fis_none(seed_val) &&
+          !(seed_val == shape_args[i])) {
+        rshape.assign(idx.num_node_entries(), empty_val);
+        seeded = false;
+      }
+    }
     for (size_t i = 0; i < shape_args.size(); ++i) {
       rshape[idx.entry_id(idx.input_nodes()[i], 0)] = shape_args[i];
     }
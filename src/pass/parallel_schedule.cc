@@ -0,0 +1,75 @@
+/*!
+ *  Copyright (c) 2018 by Contributors
+ * \file parallel_schedule.cc
+ * \brief Compute the inter-op parallel schedule of the nodes.
+ */
+#include <nnvm/graph.h>
+#include <nnvm/pass.h>
+#include <nnvm/graph_attr_types.h>
+#include <algorithm>
+#include "./graph_algorithm.h"
+
+namespace nnvm {
+namespace pass {
+namespace {
+
+Graph ParallelSchedule(Graph ret) {
+  const IndexedGraph& idx = ret.indexed_graph();
+  int num_streams = 1;
+  if (ret.attrs.count("num_streams") != 0) {
+    num_streams = ret.MoveCopyAttr<int>("num_streams");
+  }
+  CHECK_GE(num_streams, 1) << "num_streams must be positive";
+
+  ScheduleVector level(idx.num_nodes(), -1);
+  ScheduleVector dep_count(idx.num_nodes(), -1);
+  std::vector<uint32_t> importance(idx.num_nodes(), 0);
+  std::vector<uint32_t> deps;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    deps.clear();
+    for (const auto& e : inode.inputs) {
+      if (!idx[e.node_id].source->is_variable()) deps.push_back(e.node_id);
+    }
+    for (uint32_t cid : inode.control_deps) {
+      if (!idx[cid].source->is_variable()) deps.push_back(cid);
+    }
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+    // the level is the length of the longest path from the inputs.
+    int l = 0;
+    for (uint32_t dep : deps) {
+      l = std::max(l, level[dep] + 1);
+    }
+    level[nid] = l;
+    dep_count[nid] = static_cast<int>(deps.size());
+    importance[nid] = 1;
+  }
+  // the longest remaining chains get a stream each,
+  // the rest of the nodes share the last stream.
+  std::vector<uint32_t> color;
+  ColorNodeGroup(idx, importance, static_cast<uint32_t>(num_streams), &color);
+  ScheduleVector stream(idx.num_nodes(), -1);
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    if (idx[nid].source->is_variable()) continue;
+    stream[nid] = static_cast<int>(color[nid]);
+  }
+  ret.attrs["node_level"] = std::make_shared<any>(std::move(level));
+  ret.attrs["node_stream"] = std::make_shared<any>(std::move(stream));
+  ret.attrs["node_dep_count"] = std::make_shared<any>(std::move(dep_count));
+  return ret;
+}
+
+NNVM_REGISTER_PASS(ParallelSchedule)
+.describe("Assign the level, stream and dependency count of each node "
+          "for inter-op parallel execution.")
+.set_body(ParallelSchedule)
+.set_change_graph(false)
+.provide_graph_attr("node_level")
+.provide_graph_attr("node_stream")
+.provide_graph_attr("node_dep_count");
+
+}  // namespace
+}  // namespace pass
+}  // namespace nnvm
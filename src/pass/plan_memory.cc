@@ -43,10 +43,12 @@ class GraphAllocator {
       if (e->device_id != dev_id) continue;
       if (node_color_.size() != 0 &&
           node_color_[e->released_by_node] != node_color_[node_id]) continue;
+      if (!this->Reusable(e, node_id)) continue;
       // Use exect matching strategy
       e->max_bytes = std::max(size, e->max_bytes);
       // find a exact match, erase from map and return
       free_.erase(it);
+      this->Touch(e->id, node_id);
       return e->id;
     }
     // then search for memory blocks smaller than requested space
@@ -56,14 +58,24 @@ class GraphAllocator {
       if (e->device_id != dev_id) continue;
       if (node_color_.size() != 0 &&
           node_color_[e->released_by_node] != node_color_[node_id]) continue;
+      if (!this->Reusable(e, node_id)) continue;
       // Use exect matching strategy
       e->max_bytes = std::max(size, e->max_bytes);
       // erase from map and return
       free_.erase(it);
+      this->Touch(e->id, node_id);
       return e->id;
     }
     // cannot find anything return a new one.
-    return this->Alloc(dev_id, size);
+    StorageID id = this->Alloc(dev_id, size);
+    this->Touch(id, node_id);
+    return id;
+  }
+  // record that a node reads or writes the storage.
+  void Touch(StorageID id, uint32_t node_id) {
+    if (node_level_ == nullptr || id < 0) return;
+    StorageEntry *e = data_[id].get();
+    e->max_level = std::max(e->max_level, (*node_level_)[node_id]);
   }
   // release a memory space.
   void Release(StorageID id, uint32_t node_id) {
@@ -84,7 +96,9 @@ class GraphAllocator {
   }
 
   // constructor
-  explicit GraphAllocator(const IndexedGraph* idx, const size_t match_range) : idx_(idx) {
+  GraphAllocator(const IndexedGraph* idx, const size_t match_range,
+                 const ScheduleVector* node_level)
+      : node_level_(node_level), idx_(idx) {
     this->Init(match_range, dmlc::GetEnv("NNVM_EXEC_NUM_TEMP", 1));
   }
 
@@ -123,7 +137,14 @@ class GraphAllocator {
     size_t max_bytes{0};
     // node index that released it last time
     uint32_t released_by_node{0};
+    // maximum level of the nodes that used it
+    int max_level{-1};
   };
+  // With a parallel schedule, the nodes of a level run concurrently,
+  // so a storage is only reused by a later level than all its users.
+  bool Reusable(const StorageEntry* e, uint32_t node_id) const {
+    return node_level_ == nullptr || e->max_level < (*node_level_)[node_id];
+  }
   // scale used for rough match
   size_t match_range_;
   // whether use color based match algorithm
@@ -136,6 +157,8 @@ class GraphAllocator {
   std::vector<std::unique_ptr<StorageEntry> > data_;
   // color of nodes in the graph, used for auxiliary policy making.
   std::vector<uint32_t> node_color_;
+  // level of nodes in the parallel schedule, nullptr if sequential.
+  const ScheduleVector* node_level_;
   // internal indexed graph
   const IndexedGraph* idx_;
 };
@@ -248,6 +271,7 @@ size_t AllocMemory(const Graph& ret, const IndexedGraph& idx,
       auto sid = storage[eid];
       // storage_ref_count == 0 means it is taken by inplace op
       if (sid < 0) continue;
+      allocator->Touch(sid, nid);
       // if we decrease it to zero, means we are ready to relase
       --storage_ref_count[sid];
       if (storage_ref_count[sid] == 0) {
@@ -308,6 +332,11 @@ Graph PlanMemory(Graph ret) {
       ++ref_count[idx.entry_id(e)];
     }
   }
+  // level of each node if the graph has a parallel schedule.
+  const ScheduleVector* node_level = nullptr;
+  if (ret.attrs.count("node_level") != 0) {
+    node_level = &(ret.GetAttr<ScheduleVector>("node_level"));
+  }
   // step 2: allocate memory.
   StorageVector storage;
   if (ret.attrs.count("storage") != 0) {
@@ -327,7 +356,7 @@ Graph PlanMemory(Graph ret) {
     std::vector<int> storage_inplace_index(idx.num_node_entries(), -1);
 
     // the allocator
-    GraphAllocator allocator(&idx, match_range);
+    GraphAllocator allocator(&idx, match_range, node_level);
 
     // number of entries that are not statically allocated.
     size_t storage_num_not_allocated =
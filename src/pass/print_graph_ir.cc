@@ -32,6 +32,9 @@ AttrPrinter GetVectorPrinter(const Graph& graph,
   } else if (value.type() == typeid(std::vector<int>)) {
     return GetVectorPrinter_(
         nnvm::get<std::vector<int> >(value));
+  } else if (value.type() == typeid(std::vector<uint64_t>)) {
+    return GetVectorPrinter_(
+        nnvm::get<std::vector<uint64_t> >(value));
   } else if (value.type() == typeid(std::vector<std::string>)) {
     return GetVectorPrinter_(
         nnvm::get<std::vector<std::string> >(value));
@@ -71,10 +74,10 @@ void PrintGraphIR_(Graph src,
   }
   for (const std::string& key : join_node_attrs) {
     AttrPrinter fp = GetVectorPrinter(src, key);
-    auto fprint = [&idx, key, fp](
+    auto fprint = [key, fp](
         uint32_t nid, std::ostream& os) {  // NOLINT(*)
       os << ", " << key << "=";
-      fp(idx.entry_id(nid, 0), os);
+      fp(nid, os);
     };
     trigger.push_back(fprint);
   }
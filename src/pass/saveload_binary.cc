@@ -0,0 +1,356 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file saveload_binary.cc
+ * \brief Save and load graph to/from compact binary format.
+ *
+ *  The binary format holds the same content as the JSON format.
+ *  Op names and attribute strings are interned in a string table,
+ *  integers are varint encoded, shape and integer list graph
+ *  attributes are stored as packed arrays, other graph attributes
+ *  are stored in their JSON form.
+ */
+#include <nnvm/pass.h>
+#include <nnvm/pass_functions.h>
+#include <dmlc/json.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <typeinfo>
+
+namespace nnvm {
+namespace pass {
+namespace {
+
+// magic number of the binary graph format
+constexpr uint64_t kNNVMBinaryGraphMagic = 0x4E4E564D47524231;
+
+// type of the graph attributes in binary format.
+enum BinaryAttrType : uint8_t {
+  // stored in JSON form
+  kJSONAttr = 0,
+  kStrAttr = 1,
+  kShapeListAttr = 2,
+  kIntListAttr = 3
+};
+
+// writer of the binary format, with interned strings.
+class BinaryWriter {
+ public:
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+  // zigzag encoding for small negative values
+  void WriteSigned(int64_t value) {
+    WriteVarint((static_cast<uint64_t>(value) << 1) ^
+                static_cast<uint64_t>(value >> 63));
+  }
+  void WriteString(const std::string& str) {
+    WriteVarint(str.length());
+    data_.append(str);
+  }
+  // index of the string in the string table
+  uint64_t Intern(const std::string& str) {
+    auto it = symbol_map_.find(str);
+    if (it == symbol_map_.end()) {
+      it = symbol_map_.emplace(str, symbols_.size()).first;
+      symbols_.push_back(&(it->first));
+    }
+    return it->second;
+  }
+  void WriteSymbol(const std::string& str) {
+    WriteVarint(Intern(str));
+  }
+  void WriteByte(uint8_t value) {
+    data_.push_back(static_cast<char>(value));
+  }
+  // the magic, the string table and the content
+  std::string Finalize() {
+    BinaryWriter table;
+    table.WriteVarint(symbols_.size());
+    for (const std::string* str : symbols_) {
+      table.WriteString(*str);
+    }
+    std::string ret(sizeof(kNNVMBinaryGraphMagic), '\0');
+    std::memcpy(&ret[0], &kNNVMBinaryGraphMagic, sizeof(kNNVMBinaryGraphMagic));
+    ret.append(table.data_);
+    ret.append(data_);
+    return ret;
+  }
+
+ private:
+  std::string data_;
+  std::unordered_map<std::string, uint64_t> symbol_map_;
+  std::vector<const std::string*> symbols_;
+};
+
+class BinaryReader {
+ public:
+  explicit BinaryReader(const std::string& data)
+      : data_(data.data()), size_(data.length()) {
+    uint64_t magic;
+    CHECK_GE(size_, sizeof(magic)) << "invalid binary graph format";
+    std::memcpy(&magic, data_, sizeof(magic));
+    CHECK_EQ(magic, kNNVMBinaryGraphMagic) << "invalid binary graph format";
+    pos_ = sizeof(magic);
+    size_t num_symbols = ReadSize();
+    symbols_.reserve(num_symbols);
+    for (size_t i = 0; i < num_symbols; ++i) {
+      symbols_.emplace_back(ReadString());
+    }
+  }
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; ; shift += 7) {
+      CHECK(pos_ < size_ && shift < 64) << "invalid binary graph format";
+      uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) break;
+    }
+    return value;
+  }
+  int64_t ReadSigned() {
+    uint64_t value = ReadVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  // read a count, which can not exceed the remaining bytes
+  size_t ReadSize() {
+    uint64_t value = ReadVarint();
+    CHECK_LE(value, size_ - pos_) << "invalid binary graph format";
+    return static_cast<size_t>(value);
+  }
+  std::string ReadString() {
+    size_t len = ReadSize();
+    std::string ret(data_ + pos_, len);
+    pos_ += len;
+    return ret;
+  }
+  const std::string& ReadSymbol() {
+    uint64_t index = ReadVarint();
+    CHECK_LT(index, symbols_.size()) << "invalid binary graph format";
+    return symbols_[index];
+  }
+  uint8_t ReadByte() {
+    CHECK_LT(pos_, size_) << "invalid binary graph format";
+    return static_cast<uint8_t>(data_[pos_++]);
+  }
+  const std::vector<std::string>& symbols() const {
+    return symbols_;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_{0};
+  std::vector<std::string> symbols_;
+};
+
+inline void WriteEntry(BinaryWriter* writer,
+                       const std::unordered_map<Node*, uint32_t>& node2index,
+                       const NodeEntry& e) {
+  writer->WriteVarint(node2index.at(e.node.get()));
+  writer->WriteVarint(e.index);
+  writer->WriteVarint(e.version);
+}
+
+// read an entry of the first num_nodes nodes, which are already loaded.
+inline NodeEntry ReadEntry(BinaryReader* reader,
+                           const std::vector<NodePtr>& nodes,
+                           size_t num_nodes) {
+  uint64_t nid = reader->ReadVarint();
+  CHECK_LT(nid, num_nodes) << "invalid binary graph format";
+  uint32_t index = static_cast<uint32_t>(reader->ReadVarint());
+  uint32_t version = static_cast<uint32_t>(reader->ReadVarint());
+  return NodeEntry{nodes[nid], index, version};
+}
+
+inline void WriteGraphAttr(BinaryWriter* writer, const any& value) {
+  if (value.type() == typeid(std::string)) {
+    writer->WriteByte(kStrAttr);
+    writer->WriteString(nnvm::get<std::string>(value));
+  } else if (value.type() == typeid(ShapeVector)) {
+    writer->WriteByte(kShapeListAttr);
+    const ShapeVector& shapes = nnvm::get<ShapeVector>(value);
+    writer->WriteVarint(shapes.size());
+    for (const TShape& shape : shapes) {
+      writer->WriteVarint(shape.ndim());
+      for (dim_t dim : shape) {
+        writer->WriteSigned(dim);
+      }
+    }
+  } else if (value.type() == typeid(std::vector<int>)) {
+    writer->WriteByte(kIntListAttr);
+    const std::vector<int>& vec = nnvm::get<std::vector<int> >(value);
+    writer->WriteVarint(vec.size());
+    for (int v : vec) {
+      writer->WriteSigned(v);
+    }
+  } else {
+    writer->WriteByte(kJSONAttr);
+    std::ostringstream os;
+    dmlc::JSONWriter json_writer(&os);
+    json_writer.Write(value);
+    writer->WriteString(os.str());
+  }
+}
+
+inline std::shared_ptr<any> ReadGraphAttr(BinaryReader* reader) {
+  uint8_t type = reader->ReadByte();
+  if (type == kStrAttr) {
+    return std::make_shared<any>(reader->ReadString());
+  } else if (type == kShapeListAttr) {
+    ShapeVector shapes(reader->ReadSize());
+    for (TShape& shape : shapes) {
+      shape = TShape(static_cast<uint32_t>(reader->ReadSize()));
+      for (dim_t& dim : shape) {
+        dim = reader->ReadSigned();
+      }
+    }
+    return std::make_shared<any>(std::move(shapes));
+  } else if (type == kIntListAttr) {
+    std::vector<int> vec(reader->ReadSize());
+    for (int& v : vec) {
+      v = static_cast<int>(reader->ReadSigned());
+    }
+    return std::make_shared<any>(std::move(vec));
+  }
+  CHECK_EQ(type, kJSONAttr) << "invalid binary graph format";
+  std::istringstream is(reader->ReadString());
+  dmlc::JSONReader json_reader(&is);
+  any value;
+  json_reader.Read(&value);
+  return std::make_shared<any>(std::move(value));
+}
+
+// Load a graph from binary format.
+Graph LoadBinary(Graph src) {
+  CHECK_NE(src.attrs.count("binary"), 0U)
+      << "Load binary require binary to be presented.";
+  const std::string& bytes = nnvm::get<std::string>(*src.attrs.at("binary"));
+  BinaryReader reader(bytes);
+  // the loaded nodes share one arena.
+  NodeArenaScope arena_scope;
+  // op of each interned string, looked up once.
+  const std::vector<std::string>& symbols = reader.symbols();
+  std::vector<const Op*> op_cache(symbols.size(), nullptr);
+  std::vector<NodePtr> nodes(reader.ReadSize());
+  for (size_t nid = 0; nid < nodes.size(); ++nid) {
+    uint64_t op_id = reader.ReadVarint();
+    NodePtr n = op_id != 0 ? Node::Create() : Node::CreateVariable();
+    if (op_id != 0) {
+      CHECK_LE(op_id, op_cache.size()) << "invalid binary graph format";
+      const Op*& op = op_cache[op_id - 1];
+      if (op == nullptr) {
+        op = Op::Get(symbols[op_id - 1]);
+      }
+      n->attrs.op = op;
+    }
+    n->attrs.name = reader.ReadSymbol();
+    size_t num_attrs = reader.ReadSize();
+    n->attrs.dict.reserve(num_attrs);
+    for (size_t i = 0; i < num_attrs; ++i) {
+      const std::string& key = reader.ReadSymbol();
+      n->attrs.dict[key] = reader.ReadSymbol();
+    }
+    nodes[nid] = n;
+    size_t num_inputs = reader.ReadSize();
+    n->inputs.reserve(num_inputs);
+    for (size_t i = 0; i < num_inputs; ++i) {
+      n->inputs.emplace_back(ReadEntry(&reader, nodes, nid));
+    }
+    size_t num_deps = reader.ReadSize();
+    n->control_deps.reserve(num_deps);
+    for (size_t i = 0; i < num_deps; ++i) {
+      uint64_t dep = reader.ReadVarint();
+      CHECK_LT(dep, nid) << "invalid binary graph format";
+      n->control_deps.push_back(nodes[dep]);
+    }
+    if (n->op() != nullptr && n->op()->attr_parser != nullptr) {
+      n->op()->attr_parser(&(n->attrs));
+    }
+  }
+  Graph ret;
+  size_t num_heads = reader.ReadSize();
+  ret.outputs.reserve(num_heads);
+  for (size_t i = 0; i < num_heads; ++i) {
+    ret.outputs.emplace_back(ReadEntry(&reader, nodes, nodes.size()));
+  }
+  size_t num_attrs = reader.ReadSize();
+  for (size_t i = 0; i < num_attrs; ++i) {
+    std::string key = reader.ReadString();
+    ret.attrs[key] = ReadGraphAttr(&reader);
+  }
+  return ret;
+}
+
+// save a graph to binary format
+Graph SaveBinary(Graph src) {
+  BinaryWriter writer;
+  std::vector<NodePtr> nodes;
+  std::unordered_map<Node*, uint32_t> node2index;
+  DFSVisit(src.outputs, [&nodes, &node2index](const NodePtr& n) {
+      node2index[n.get()] = static_cast<uint32_t>(nodes.size());
+      nodes.push_back(n);
+    });
+  writer.WriteVarint(nodes.size());
+  for (const NodePtr& n : nodes) {
+    // 0 is the variable, the interned op name is offset by one.
+    if (n->op() != nullptr) {
+      writer.WriteVarint(writer.Intern(n->op()->name) + 1);
+    } else {
+      writer.WriteVarint(0);
+    }
+    writer.WriteSymbol(n->attrs.name);
+    // write attributes in order
+    std::map<std::string, std::string> dict(
+        n->attrs.dict.begin(), n->attrs.dict.end());
+    writer.WriteVarint(dict.size());
+    for (const auto& kv : dict) {
+      writer.WriteSymbol(kv.first);
+      writer.WriteSymbol(kv.second);
+    }
+    writer.WriteVarint(n->inputs.size());
+    for (const NodeEntry& e : n->inputs) {
+      WriteEntry(&writer, node2index, e);
+    }
+    writer.WriteVarint(n->control_deps.size());
+    for (const NodePtr& c : n->control_deps) {
+      writer.WriteVarint(node2index.at(c.get()));
+    }
+  }
+  writer.WriteVarint(src.outputs.size());
+  for (const NodeEntry& e : src.outputs) {
+    WriteEntry(&writer, node2index, e);
+  }
+  std::map<std::string, std::shared_ptr<any> > attrs(
+      src.attrs.begin(), src.attrs.end());
+  writer.WriteVarint(attrs.size());
+  for (const auto& kv : attrs) {
+    writer.WriteString(kv.first);
+    WriteGraphAttr(&writer, *kv.second);
+  }
+  Graph ret;
+  ret.attrs["binary"] = std::make_shared<any>(writer.Finalize());
+  return ret;
+}
+
+// register pass
+NNVM_REGISTER_PASS(LoadBinary)
+.describe("Return a new Graph, loaded from src.attrs[\"binary\"]")
+.set_body(LoadBinary)
+.set_change_graph(true)
+.depend_graph_attr("binary");
+
+NNVM_REGISTER_PASS(SaveBinary)
+.describe("Return a new empty Graph. Save graph to ret.attrs[\"binary\"]")
+.set_body(SaveBinary)
+.set_change_graph(true)
+.provide_graph_attr("binary");
+
+}  // namespace
+}  // namespace pass
+}  // namespace nnvm
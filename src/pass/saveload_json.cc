@@ -6,7 +6,10 @@
 #include <nnvm/pass.h>
 #include <nnvm/pass_functions.h>
 #include <dmlc/json.h>
+#include <dmlc/memory_io.h>
 #include <algorithm>
+#include <exception>
+#include <thread>
 
 namespace dmlc {
 namespace json {
@@ -60,6 +63,8 @@ struct JSONNode {
 
   // pointer to the graph node
   NodePtr node;
+  // op name, resolved after loading all the nodes
+  std::string op_name;
   // inputs
   std::vector<Entry> inputs;
   // control flow dependencies
@@ -92,8 +97,7 @@ struct JSONNode {
     node = Node::Create();
     control_deps.clear();
     dmlc::JSONObjectReadHelper helper;
-    std::string op_type_str;
-    helper.DeclareField("op", &op_type_str);
+    helper.DeclareField("op", &op_name);
     helper.DeclareField("name", &(node->attrs.name));
     helper.DeclareField("inputs", &inputs);
     helper.DeclareOptionalField("attrs", &(node->attrs.dict));
@@ -106,18 +110,11 @@ struct JSONNode {
     helper.DeclareOptionalField("backward_source_id", &backward_source_id);
     helper.ReadAllFields(reader);
     node->attrs.dict.insert(param.begin(), param.end());
-
-    if (op_type_str != "null") {
-      try {
-        node->attrs.op = Op::Get(op_type_str);
-      } catch (const dmlc::Error &err) {
-        std::ostringstream os;
-        os << "Failed loading Op " << node->attrs.name
-           << " of type " << op_type_str << ": " << err.what();
-        throw dmlc::Error(os.str());
-      }
-    } else {
-      node->attrs.op = nullptr;
+    if (op_name == "null") {
+      // variables are allocated outside the arena of the graph.
+      NodePtr var = Node::CreateVariable();
+      var->attrs = std::move(node->attrs);
+      node = std::move(var);
     }
   }
 };
@@ -154,6 +151,47 @@ struct JSONGraph {
   }
 };
 
+// minimum number of nodes to parse the attributes in parallel
+constexpr size_t kParallelParseNodes = 4096;
+
+// The attribute parsers only read the attribute dict of their node,
+// so the nodes of large graphs are parsed by multiple threads.
+void ParseNodeAttrs(const std::vector<JSONNode>& nodes) {
+  auto parse = [&nodes](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const NodePtr& node = nodes[i].node;
+      if (node->op() != nullptr && node->op()->attr_parser != nullptr) {
+        node->op()->attr_parser(&(node->attrs));
+      }
+    }
+  };
+  size_t nthread = std::min<size_t>(
+      std::max(std::thread::hardware_concurrency(), 1U),
+      nodes.size() / kParallelParseNodes);
+  if (nthread <= 1) {
+    parse(0, nodes.size());
+    return;
+  }
+  size_t step = (nodes.size() + nthread - 1) / nthread;
+  std::vector<std::exception_ptr> errors(nthread);
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < nthread; ++tid) {
+    threads.emplace_back([&, tid]() {
+        try {
+          parse(tid * step, std::min(nodes.size(), (tid + 1) * step));
+        } catch (...) {
+          errors[tid] = std::current_exception();
+        }
+      });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (const std::exception_ptr& err : errors) {
+    if (err) std::rethrow_exception(err);
+  }
+}
+
 // Load a graph from JSON file.
 Graph LoadJSON(Graph src) {
   CHECK_NE(src.attrs.count("json"), 0U)
@@ -164,13 +202,34 @@ Graph LoadJSON(Graph src) {
   if (src.attrs.count("load_json_no_parse")) {
     no_parse = nnvm::get<bool>(*src.attrs.at("load_json_no_parse"));
   }
-  std::istringstream is(json_str);
+  // the loaded nodes share one arena.
+  NodeArenaScope arena_scope;
+  // read from the string without copying it into a stringstream.
+  dmlc::MemoryFixedSizeStream strm(
+      const_cast<char*>(json_str.data()), json_str.length());
+  dmlc::istream is(&strm);
   dmlc::JSONReader reader(&is);
   JSONGraph jgraph;
   // load in json graph.
   jgraph.Load(&reader);
+  // Op::Get locks the registry, look up each distinct op once.
+  std::unordered_map<std::string, const Op*> op_cache;
   // connects the nodes
   for (JSONNode &n : jgraph.nodes) {
+    if (n.op_name != "null") {
+      auto it = op_cache.find(n.op_name);
+      if (it == op_cache.end()) {
+        try {
+          it = op_cache.emplace(n.op_name, Op::Get(n.op_name)).first;
+        } catch (const dmlc::Error &err) {
+          std::ostringstream os;
+          os << "Failed loading Op " << n.node->attrs.name
+             << " of type " << n.op_name << ": " << err.what();
+          throw dmlc::Error(os.str());
+        }
+      }
+      n.node->attrs.op = it->second;
+    }
     n.node->inputs.reserve(n.inputs.size());
     for (const JSONNode::Entry &e : n.inputs) {
       n.node->inputs.emplace_back(
@@ -180,11 +239,10 @@ Graph LoadJSON(Graph src) {
     for (uint32_t nid : n.control_deps) {
       n.node->control_deps.push_back(jgraph.nodes[nid].node);
     }
-    // rebuild attribute parser
-    if (!no_parse && n.node->op() != nullptr &&
-        n.node->op()->attr_parser != nullptr) {
-      n.node->op()->attr_parser(&(n.node->attrs));
-    }
+  }
+  // rebuild attribute parser
+  if (!no_parse) {
+    ParseNodeAttrs(jgraph.nodes);
   }
   // consistent check
   for (uint32_t nid : jgraph.arg_nodes) {
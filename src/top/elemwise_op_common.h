@@ -106,6 +106,8 @@ inline bool ElementWiseReduceType(const NodeAttrs& attrs,
   .set_num_outputs(1)                                               \
   .set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 1>)        \
   .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)           \
+  .set_attr<nnvm::compiler::FEstimateCost>(                         \
+    "FEstimateCost", ElemwiseCost)                                  \
   .set_attr<FInplaceOption>("FInplaceOption",                       \
     [](const NodeAttrs& attrs){                                     \
       return std::vector<std::pair<int, int> >{{0, 0}};             \
@@ -131,6 +133,8 @@ inline bool ElementWiseReduceType(const NodeAttrs& attrs,
   .set_num_outputs(1)                                               \
   .set_attr<FInferShape>("FInferShape", ElemwiseShape<2, 1>)        \
   .set_attr<FInferType>("FInferType", ElemwiseType<2, 1>)           \
+  .set_attr<nnvm::compiler::FEstimateCost>(                         \
+    "FEstimateCost", ElemwiseCost)                                  \
   .set_attr<FInplaceOption>("FInplaceOption",                       \
     [](const NodeAttrs& attrs) {                                    \
       return std::vector<std::pair<int, int> >{{0, 0}, {1, 0}};     \
@@ -151,12 +155,16 @@ inline bool ElementWiseReduceType(const NodeAttrs& attrs,
   .set_attr<nnvm::FInferShape>("FInferShape",                       \
     ElementWiseReduceShape)                                         \
   .set_attr<nnvm::FInferType>("FInferType", ElementWiseReduceType)  \
+  .set_attr<nnvm::compiler::FEstimateCost>(                         \
+    "FEstimateCost", ReduceCost)                                    \
   .add_argument("args", "Symbol[]", "Positional input arguments")
 
 
 #define NNVM_REGISTER_INDICATOR_OP(name)                            \
   NNVM_REGISTER_OP(name)                                            \
   .set_num_outputs(1)                                               \
+  .set_attr<nnvm::compiler::FEstimateCost>(                         \
+    "FEstimateCost", ElemwiseCost)                                  \
   .set_attr<FInferType>(                                            \
     "FInferType", [](const NodeAttrs& attrs,                        \
                      std::vector<int>* in_attrs,                    \
@@ -0,0 +1,153 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file layout_common.h
+ * \brief Common utilities for layout strings.
+ *
+ *  A layout is a string of axes. An upper case letter is a primal axis,
+ *  a number followed by a lower case letter is a sub-axis that blocks
+ *  the corresponding primal axis by the factor, e.g. NCHW16c blocks the
+ *  channel of NCHW by 16. The "default" layout of an entry refers to the
+ *  primal layout it is used in.
+ */
+#ifndef NNVM_TOP_LAYOUT_COMMON_H_
+#define NNVM_TOP_LAYOUT_COMMON_H_
+
+#include <dmlc/logging.h>
+#include <nnvm/tuple.h>
+#include <cctype>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nnvm {
+namespace top {
+
+/*! \brief A layout axis, factor is 0 for a primal axis. */
+using LayoutAxis = std::pair<char, int>;
+
+/*!
+ * \brief Parse layout string into axes.
+ * \param layout The layout string.
+ * \param axes The parsed axes.
+ * \return Whether the layout is valid.
+ */
+inline bool ParseLayout(const std::string& layout,
+                        std::vector<LayoutAxis>* axes) {
+  axes->clear();
+  int factor = 0;
+  for (char c : layout) {
+    if (std::isdigit(c)) {
+      factor = factor * 10 + (c - '0');
+    } else if (std::isupper(c)) {
+      if (factor != 0) return false;
+      for (const LayoutAxis& a : *axes) {
+        if (a.first == c) return false;
+      }
+      axes->emplace_back(c, 0);
+    } else if (std::islower(c)) {
+      if (factor <= 0) return false;
+      bool has_primal = false;
+      for (const LayoutAxis& a : *axes) {
+        if (a.first == c) return false;
+        if (a.first == std::toupper(c)) has_primal = true;
+      }
+      if (!has_primal) return false;
+      axes->emplace_back(c, factor);
+      factor = 0;
+    } else {
+      return false;
+    }
+  }
+  return factor == 0;
+}
+
+/*! \brief Get the primal layout, i.e. NCHW of NCHW16c. */
+inline std::string PrimalLayout(const std::string& layout) {
+  std::string ret;
+  for (char c : layout) {
+    if (std::isupper(c)) ret.push_back(c);
+  }
+  return ret;
+}
+
+/*! \brief Get the factor of the sub-axis of primal axis, 0 if not blocked. */
+inline int LayoutSubFactor(const std::vector<LayoutAxis>& axes, char primal) {
+  for (const LayoutAxis& a : axes) {
+    if (a.second != 0 && a.first == std::tolower(primal)) return a.second;
+  }
+  return 0;
+}
+
+/*!
+ * \brief Get the layout of the last num_axis primal axes,
+ *  i.e. CHW16c is the sub layout of NCHW16c with 3 axes.
+ */
+inline std::string SubLayout(const std::vector<LayoutAxis>& axes, size_t num_axis) {
+  std::string primal;
+  for (const LayoutAxis& a : axes) {
+    if (a.second == 0) primal.push_back(a.first);
+  }
+  CHECK_LE(num_axis, primal.length());
+  primal = primal.substr(primal.length() - num_axis);
+  std::string ret;
+  for (const LayoutAxis& a : axes) {
+    if (primal.find(std::toupper(a.first)) == std::string::npos) continue;
+    if (a.second != 0) ret += std::to_string(a.second);
+    ret.push_back(a.first);
+  }
+  return ret;
+}
+
+/*!
+ * \brief Convert shape in src layout to shape in dst layout.
+ * \param src The shape in src_layout.
+ * \param src_layout The source layout.
+ * \param dst_layout The target layout, must have the same primal axes.
+ * \return The shape in dst layout.
+ */
+inline TShape ConvertShapeLayout(const TShape& src,
+                                 const std::string& src_layout,
+                                 const std::string& dst_layout) {
+  std::vector<LayoutAxis> saxes, daxes;
+  CHECK(ParseLayout(src_layout, &saxes)) << "Invalid layout " << src_layout;
+  CHECK(ParseLayout(dst_layout, &daxes)) << "Invalid layout " << dst_layout;
+  CHECK_EQ(src.ndim(), saxes.size())
+      << "Shape " << src << " does not match layout " << src_layout;
+  // size of each primal axis
+  std::vector<std::pair<char, dim_t> > primal;
+  for (size_t i = 0; i < saxes.size(); ++i) {
+    if (saxes[i].second != 0) continue;
+    int factor = LayoutSubFactor(saxes, saxes[i].first);
+    primal.emplace_back(saxes[i].first, src[i] * (factor != 0 ? factor : 1));
+  }
+  CHECK_EQ(PrimalLayout(src_layout).length(), PrimalLayout(dst_layout).length())
+      << "Cannot convert layout " << src_layout << " to " << dst_layout;
+  TShape dst(daxes.size());
+  for (size_t i = 0; i < daxes.size(); ++i) {
+    char axis = static_cast<char>(std::toupper(daxes[i].first));
+    dim_t size = -1;
+    for (const auto& p : primal) {
+      if (p.first == axis) size = p.second;
+    }
+    CHECK_GE(size, 0)
+        << "Cannot convert layout " << src_layout << " to " << dst_layout;
+    if (daxes[i].second != 0) {
+      dst[i] = daxes[i].second;
+    } else {
+      int factor = LayoutSubFactor(daxes, daxes[i].first);
+      if (factor != 0) {
+        CHECK_EQ(size % factor, 0)
+            << "Axis " << axis << " of size " << size
+            << " cannot be blocked by " << factor;
+        size /= factor;
+      }
+      dst[i] = size;
+    }
+  }
+  return dst;
+}
+
+}  // namespace top
+}  // namespace nnvm
+
+#endif  // NNVM_TOP_LAYOUT_COMMON_H_
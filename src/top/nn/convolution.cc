@@ -6,6 +6,7 @@
 #include <nnvm/op.h>
 #include <nnvm/node.h>
 #include <nnvm/op_attr_types.h>
+#include <nnvm/compiler/op_attr_types.h>
 #include <nnvm/top/nn.h>
 #include "./nn_common.h"
 #include "../op_common.h"
@@ -14,6 +15,8 @@
 namespace nnvm {
 namespace top {
 
+using nnvm::compiler::FEstimateCost;
+
 // conv2d
 DMLC_REGISTER_PARAMETER(Conv2DParam);
 
@@ -93,6 +96,18 @@ inline bool Conv2DInferShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+// two operations per multiply-add, the weight size divided by
+// the output channels is the reduction size of an output element.
+inline uint64_t Conv2DCost(const NodeAttrs& attrs,
+                           const std::vector<TShape>& ishapes,
+                           const std::vector<TShape>& oshapes) {
+  const Conv2DParam& param = nnvm::get<Conv2DParam>(attrs.parsed);
+  uint64_t out_size = oshapes[0].Size();
+  uint64_t flop = 2 * out_size * (ishapes[Conv2DParam::kWeight].Size() / param.channels);
+  if (param.use_bias) flop += out_size;
+  return flop;
+}
+
 NNVM_REGISTER_OP(conv2d)
 .describe(R"code(2D convolution layer (e.g. spatial convolution over images).
 
@@ -117,7 +132,8 @@ a bias vector is created and added to the outputs.
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<Conv2DParam>)
 .set_attr<FListInputNames>("FListInputNames", UseBiasListInputNames<Conv2DParam>)
 .set_attr<FInferShape>("FInferShape", Conv2DInferShape)
-.set_attr<FInferType>("FInferType", ElemwiseType<-1, 1>)
+.set_attr<FInferType>("FInferType", OutDTypeInferType<Conv2DParam>)
+.set_attr<FEstimateCost>("FEstimateCost", Conv2DCost)
 .set_num_outputs(1)
 .set_num_inputs(UseBiasNumInputs<Conv2DParam>)
 .set_support_level(2)
@@ -212,6 +228,18 @@ inline bool Conv2DTransposeInferShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+// each input element is multiplied by channels / groups kernels.
+inline uint64_t Conv2DTransposeCost(const NodeAttrs& attrs,
+                                    const std::vector<TShape>& ishapes,
+                                    const std::vector<TShape>& oshapes) {
+  const Conv2DTransposeParam& param = nnvm::get<Conv2DTransposeParam>(attrs.parsed);
+  uint64_t kernel_size = param.kernel_size[0] * param.kernel_size[1];
+  uint64_t flop = 2 * ishapes[Conv2DTransposeParam::kData].Size() *
+      (param.channels / param.groups) * kernel_size;
+  if (param.use_bias) flop += oshapes[0].Size();
+  return flop;
+}
+
 NNVM_REGISTER_OP(conv2d_transpose)
 .describe(R"code(Transposed 2D convolution layer (sometimes called Deconvolution).
 
@@ -243,6 +271,7 @@ said convolution.
 .set_attr<FListInputNames>("FListInputNames", UseBiasListInputNames<Conv2DTransposeParam>)
 .set_attr<FInferShape>("FInferShape", Conv2DTransposeInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<-1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", Conv2DTransposeCost)
 .set_num_outputs(1)
 .set_num_inputs(UseBiasNumInputs<Conv2DTransposeParam>)
 .set_support_level(2);
@@ -23,6 +23,7 @@ namespace top {
 using tvm::Tensor;
 using tvm::Array;
 using nnvm::compiler::FTVMCompute;
+using nnvm::compiler::FEstimateCost;
 
 // dense
 DMLC_REGISTER_PARAMETER(DenseParam);
@@ -58,6 +59,17 @@ inline bool DenseInferShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+// two operations per multiply-add, plus the bias.
+inline uint64_t DenseCost(const NodeAttrs& attrs,
+                          const std::vector<TShape>& ishapes,
+                          const std::vector<TShape>& oshapes) {
+  const DenseParam& param = nnvm::get<DenseParam>(attrs.parsed);
+  uint64_t out_size = oshapes[0].Size();
+  uint64_t flop = 2 * out_size * ishapes[DenseParam::kWeight][1];
+  if (param.use_bias) flop += out_size;
+  return flop;
+}
+
 NNVM_REGISTER_OP(dense)
 .describe(R"code(Applies a linear transformation: :math:`Y = XW^T + b`.
 
@@ -81,7 +93,8 @@ If ``use_bias`` is set to be false, then the ``bias`` term is ignored.
 .set_num_inputs(UseBiasNumInputs<DenseParam>)
 .set_attr<FListInputNames>("FListInputNames", UseBiasListInputNames<DenseParam>)
 .set_attr<FInferShape>("FInferShape", DenseInferShape)
-.set_attr<FInferType>("FInferType", ElemwiseType<-1, 1>)
+.set_attr<FInferType>("FInferType", OutDTypeInferType<DenseParam>)
+.set_attr<FEstimateCost>("FEstimateCost", DenseCost)
 .set_attr<FGradient>(
   "FGradient", [](const NodePtr& n,
                   const std::vector<NodeEntry>& ograds) {
@@ -161,6 +174,7 @@ NNVM_REGISTER_OP(dropout)
 .set_num_outputs(2)
 .set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 2>)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 2>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_attr<FNumVisibleOutputs>("FNumVisibleOutputs", [](const NodeAttrs& attrs) {
     return 1;
   })
@@ -259,6 +273,13 @@ axis to be the last item in the input shape.
 // softmax
 DMLC_REGISTER_PARAMETER(SoftmaxParam);
 
+// exp, sum and division of each element.
+inline uint64_t SoftmaxCost(const NodeAttrs& attrs,
+                            const std::vector<TShape>& ishapes,
+                            const std::vector<TShape>& oshapes) {
+  return 3 * oshapes[0].Size();
+}
+
 NNVM_REGISTER_OP(softmax)
 .describe(R"code(Computes softmax.
 
@@ -275,6 +296,7 @@ NNVM_REGISTER_OP(softmax)
 .set_num_outputs(1)
 .set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 1>)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", SoftmaxCost)
 .set_support_level(1)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
@@ -331,6 +353,7 @@ NNVM_REGISTER_OP(log_softmax)
 .set_num_outputs(1)
 .set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 1>)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", SoftmaxCost)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -388,6 +411,7 @@ NNVM_REGISTER_OP(leaky_relu)
 .set_num_outputs(1)
 .set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 1>)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ElemwiseCost)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -452,6 +476,7 @@ NNVM_REGISTER_OP(pad)
 .set_num_inputs(1)
 .set_attr<FInferShape>("FInferShape", PadInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
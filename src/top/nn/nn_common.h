@@ -13,6 +13,8 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include "../op_common.h"
+#include "../elemwise_op_common.h"
 
 namespace nnvm {
 namespace top {
@@ -33,6 +35,32 @@ inline std::vector<std::string> UseBiasListInputNames(const NodeAttrs& attrs) {
   }
 }
 
+/*!
+ * \brief Infer type of op with out_dtype parameter, i.e. conv2d and dense.
+ *  The inputs share one type, the output type is out_dtype when it is set.
+ */
+template<typename ParamType>
+inline bool OutDTypeInferType(const NodeAttrs& attrs,
+                              std::vector<int>* in_attrs,
+                              std::vector<int>* out_attrs) {
+  const ParamType& param = nnvm::get<ParamType>(attrs.parsed);
+  if (param.out_dtype == -1) {
+    return ElemwiseType<-1, 1>(attrs, in_attrs, out_attrs);
+  }
+  CHECK_EQ(out_attrs->size(), 1U);
+  int dtype = -1;
+  for (int t : *in_attrs) {
+    if (t != -1) {
+      dtype = t; break;
+    }
+  }
+  for (size_t i = 0; i < in_attrs->size(); ++i) {
+    NNVM_ASSIGN_INPUT_TYPE(attrs, *in_attrs, i, dtype);
+  }
+  NNVM_ASSIGN_OUTPUT_TYPE(attrs, *out_attrs, 0, param.out_dtype);
+  return dtype != -1;
+}
+
 /*!
  * \brief Convert shape in src_layout to shape in dst_layout
  * \param src original shape
@@ -12,7 +12,10 @@
 #include "./nn_common.h"
 #include "../op_common.h"
 #include "../elemwise_op_common.h"
+#include "../layout_common.h"
+#include "topi/nn.h"
 #include "topi/nn/pooling.h"
+#include "topi/tags.h"
 
 namespace nnvm {
 namespace top {
@@ -21,6 +24,81 @@ using namespace nnvm::compiler;
 
 DMLC_REGISTER_PARAMETER(Pool2DParam);
 
+/*!
+ * \brief Pooling operators support the NCHW layout with the channel
+ *  blocked, e.g. NCHW16c, the blocked data is 5D.
+ */
+template<typename PType>
+inline bool PoolLayoutSupport(const NodeAttrs& attrs,
+                              const std::vector<TShape>& ishapes,
+                              std::vector<TLayoutInfo> *ilayouts,
+                              std::vector<TLayoutInfo> *olayouts) {
+  const PType& param = nnvm::get<PType>(attrs.parsed);
+  if (param.layout != kNCHW) return false;
+  const TLayoutInfo& layout = (*ilayouts)[0];
+  std::vector<LayoutAxis> axes;
+  if (!ParseLayout(layout, &axes) || PrimalLayout(layout) != "NCHW") return false;
+  if (axes.size() == 5) {
+    if (axes[4].first != 'c') return false;
+  } else if (axes.size() != 4) {
+    return false;
+  }
+  (*olayouts)[0] = layout;
+  return true;
+}
+
+// Pooling on 5D data in blocked NCHWc layout.
+inline Tensor BlockedPool2D(const Tensor& x,
+                            const Pool2DParam& param,
+                            topi::nn::PoolType pool_type,
+                            const Array<Expr>& out_shape) {
+  int stride_h = param.strides[0], stride_w = param.strides[1];
+  int pad_h = param.padding[0], pad_w = param.padding[1];
+  int tail_h = param.ceil_mode ? stride_h - 1 : 0;
+  int tail_w = param.ceil_mode ? stride_w - 1 : 0;
+  Array<Expr> pad_before{Expr(0), Expr(0), Expr(pad_h), Expr(pad_w), Expr(0)};
+  Array<Expr> pad_after{Expr(0), Expr(0), Expr(pad_h + tail_h), Expr(pad_w + tail_w), Expr(0)};
+  auto dh = tvm::reduce_axis(Range(0, static_cast<int>(param.pool_size[0])), "rv_h");
+  auto dw = tvm::reduce_axis(Range(0, static_cast<int>(param.pool_size[1])), "rv_w");
+  if (pool_type == topi::nn::kMaxPool) {
+    Tensor temp = topi::pad(x, pad_before, pad_after, x->dtype.min(), "pad_temp");
+    return tvm::compute(out_shape, [&](const Array<Var>& i) {
+      return tvm::max(temp(i[0], i[1], i[2] * stride_h + dh, i[3] * stride_w + dw, i[4]),
+                      {dh, dw});
+    }, "tensor", "pool_max");
+  } else {
+    Tensor temp = topi::pad(x, pad_before, pad_after, make_zero(x->dtype), "pad_temp");
+    Tensor tsum = tvm::compute(out_shape, [&](const Array<Var>& i) {
+      return tvm::sum(temp(i[0], i[1], i[2] * stride_h + dh, i[3] * stride_w + dw, i[4]),
+                      {dh, dw});
+    }, "tensor", "pool_avg");
+    int kernel_size = static_cast<int>(param.pool_size[0] * param.pool_size[1]);
+    return tvm::compute(out_shape, [&](const Array<Var>& i) {
+      return tsum(i) / kernel_size;
+    }, "tensor", topi::kElementWise);
+  }
+}
+
+// Global pooling on 5D data in blocked NCHWc layout.
+inline Tensor BlockedGlobalPool2D(const Tensor& x,
+                                  topi::nn::PoolType pool_type,
+                                  const Array<Expr>& out_shape) {
+  auto dh = tvm::reduce_axis(Range(0, x->shape[2]), "rv_h");
+  auto dw = tvm::reduce_axis(Range(0, x->shape[3]), "rv_w");
+  if (pool_type == topi::nn::kMaxPool) {
+    return tvm::compute(out_shape, [&](const Array<Var>& i) {
+      return tvm::max(x(i[0], i[1], dh, dw, i[4]), {dh, dw});
+    }, "tensor", "global_pool_max");
+  } else {
+    Tensor tsum = tvm::compute(out_shape, [&](const Array<Var>& i) {
+      return tvm::sum(x(i[0], i[1], dh, dw, i[4]), {dh, dw});
+    }, "tensor", "global_pool_sum");
+    return tvm::compute(out_shape, [&](const Array<Var>& i) {
+      return tsum(i) / tvm::cast(x->dtype, x->shape[2] * x->shape[3]);
+    }, "tensor", topi::kElementWise);
+  }
+}
+
 inline bool Pool2DInferShape(const nnvm::NodeAttrs& attrs,
                              std::vector<TShape>* in_shape,
                              std::vector<TShape>* out_shape) {
@@ -33,8 +111,8 @@ inline bool Pool2DInferShape(const nnvm::NodeAttrs& attrs,
   dshape = ConvertLayout(dshape, param.layout, kNCHW);
 
   TShape oshape = dshape;
-  CHECK_EQ(dshape.ndim(), 4U)
-      << "Pooling: Input data should be 4D";
+  CHECK(dshape.ndim() == 4U || (dshape.ndim() == 5U && param.layout == kNCHW))
+      << "Pooling: Input data should be 4D, or 5D in blocked NCHWc layout";
   CHECK(param.pool_size[0] <= dshape[2] + 2 * param.padding[0])
       << "pool size (" << param.pool_size[0] << ") exceeds input (" << dshape[2]
       << " padded to " << (dshape[2] + 2*param.padding[0]) << ")";
@@ -58,6 +136,14 @@ inline bool Pool2DInferShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+// one operation per element of each pooling window.
+inline uint64_t Pool2DCost(const NodeAttrs& attrs,
+                           const std::vector<TShape>& ishapes,
+                           const std::vector<TShape>& oshapes) {
+  const Pool2DParam& param = nnvm::get<Pool2DParam>(attrs.parsed);
+  return oshapes[0].Size() * param.pool_size[0] * param.pool_size[1];
+}
+
 NNVM_REGISTER_OP(max_pool2d)
 .describe(R"code(Max pooling operation for one dimensional data.
 
@@ -82,6 +168,8 @@ NNVM_REGISTER_OP(max_pool2d)
 .set_num_inputs(1)
 .set_attr<FInferShape>("FInferShape", Pool2DInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", Pool2DCost)
+.set_attr<FTVMLayoutSupport>("FTVMLayoutSupport", PoolLayoutSupport<Pool2DParam>)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -92,6 +180,10 @@ NNVM_REGISTER_OP(max_pool2d)
     auto padding = ShapeToArray(param.padding);
     auto ceil_mode = param.ceil_mode;
     CHECK(param.layout == kNCHW || param.layout == kNHWC) << "Unsupported layout";
+    if (inputs[0]->shape.size() == 5) {
+      return Array<Tensor>{
+        BlockedPool2D(inputs[0], param, topi::nn::kMaxPool, out_info[0]->shape) };
+    }
     std::string layout = (param.layout == kNCHW ? "NCHW" : "NHWC");
     return Array<Tensor>{
       topi::nn::pool(inputs[0], pool_size, strides, padding, \
@@ -144,6 +236,8 @@ NNVM_REGISTER_OP(avg_pool2d)
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<Pool2DParam>)
 .set_attr<FInferShape>("FInferShape", Pool2DInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", Pool2DCost)
+.set_attr<FTVMLayoutSupport>("FTVMLayoutSupport", PoolLayoutSupport<Pool2DParam>)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -154,6 +248,10 @@ NNVM_REGISTER_OP(avg_pool2d)
     auto padding = ShapeToArray(param.padding);
     auto ceil_mode = param.ceil_mode;
     CHECK(param.layout == kNCHW || param.layout == kNHWC) << "Unsupported layout";
+    if (inputs[0]->shape.size() == 5) {
+      return Array<Tensor>{
+        BlockedPool2D(inputs[0], param, topi::nn::kAvgPool, out_info[0]->shape) };
+    }
     std::string layout = (param.layout == kNCHW ? "NCHW" : "NHWC");
     return Array<Tensor>{
       topi::nn::pool(inputs[0], pool_size, strides, padding, \
@@ -197,6 +295,8 @@ NNVM_REGISTER_OP(global_max_pool2d)
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<GlobalPool2DParam>)
 .set_attr<FInferShape>("FInferShape", GlobalPool2DInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ReduceCost)
+.set_attr<FTVMLayoutSupport>("FTVMLayoutSupport", PoolLayoutSupport<GlobalPool2DParam>)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -204,6 +304,10 @@ NNVM_REGISTER_OP(global_max_pool2d)
     const GlobalPool2DParam& param = nnvm::get<GlobalPool2DParam>(attrs.parsed);
     CHECK_EQ(param.layout, kNCHW)
       << "global_max_pool2d currently only supports NCHW layout";
+    if (inputs[0]->shape.size() == 5) {
+      return Array<Tensor>{
+        BlockedGlobalPool2D(inputs[0], topi::nn::kMaxPool, out_info[0]->shape) };
+    }
     return Array<Tensor>{
       topi::nn::global_pool(inputs[0], topi::nn::kMaxPool) };
 })
@@ -227,6 +331,8 @@ NNVM_REGISTER_OP(global_avg_pool2d)
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<GlobalPool2DParam>)
 .set_attr<FInferShape>("FInferShape", GlobalPool2DInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ReduceCost)
+.set_attr<FTVMLayoutSupport>("FTVMLayoutSupport", PoolLayoutSupport<GlobalPool2DParam>)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -234,6 +340,10 @@ NNVM_REGISTER_OP(global_avg_pool2d)
     const GlobalPool2DParam& param = nnvm::get<GlobalPool2DParam>(attrs.parsed);
     CHECK_EQ(param.layout, kNCHW)
       << "global_avg_pool2d currently only supports NCHW layout";
+    if (inputs[0]->shape.size() == 5) {
+      return Array<Tensor>{
+        BlockedGlobalPool2D(inputs[0], topi::nn::kAvgPool, out_info[0]->shape) };
+    }
     return Array<Tensor>{
       topi::nn::global_pool(inputs[0], topi::nn::kAvgPool) };
 })
@@ -6,6 +6,7 @@
 #include <nnvm/op.h>
 #include <nnvm/node.h>
 #include <nnvm/op_attr_types.h>
+#include <nnvm/compiler/op_attr_types.h>
 #include <nnvm/top/nn.h>
 #include "./nn_common.h"
 #include "../op_common.h"
@@ -14,6 +15,8 @@
 namespace nnvm {
 namespace top {
 
+using nnvm::compiler::FEstimateCost;
+
 DMLC_REGISTER_PARAMETER(UpSamplingParam);
 
 inline bool UpSamplingInferShape(const nnvm::NodeAttrs& attrs,
@@ -46,6 +49,7 @@ NNVM_REGISTER_OP(upsampling)
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<UpSamplingParam>)
 .set_attr<FInferShape>("FInferShape", UpSamplingInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_outputs(1)
 .set_num_inputs(1)
 .set_support_level(2);
@@ -8,21 +8,94 @@
 
 #include <dmlc/logging.h>
 #include <dmlc/parameter.h>
+#include <dmlc/thread_local.h>
 #include <nnvm/top/tensor.h>
+#include <algorithm>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace nnvm {
 namespace top {
+
+/*! \brief Maximum number of attribute sets cached per parameter type and thread. */
+constexpr size_t kMaxParamCacheSize = 4096;
+
+/*!
+ * \brief Cache of parsed parameters, keyed by the sorted attribute dict.
+ *  The same attribute sets repeat many times in large models,
+ *  and nodes are parsed again in every copy of them.
+ *  Each thread has its own cache, so the parallel attribute parsing
+ *  of large graphs needs no lock.
+ * \tparam PType the parameter type.
+ */
+template<typename PType>
+class ParamCache {
+ public:
+  /*! \return the cache of PType of the calling thread */
+  static ParamCache* ThreadLocal() {
+    return dmlc::ThreadLocalStore<ParamCache>::Get();
+  }
+  /*!
+   * \brief Get the key of an attribute dict.
+   * \param dict The attribute dict.
+   */
+  template<typename Dict>
+  static std::string Key(const Dict& dict) {
+    using Entry = typename Dict::value_type;
+    std::vector<const Entry*> items;
+    items.reserve(dict.size());
+    for (const auto& kv : dict) {
+      items.push_back(&kv);
+    }
+    std::sort(items.begin(), items.end(), [](const Entry* a, const Entry* b) {
+        return a->first < b->first;
+      });
+    std::string key;
+    for (const auto* kv : items) {
+      key.append(kv->first);
+      key.push_back('\0');
+      key.append(kv->second);
+      key.push_back('\0');
+    }
+    return key;
+  }
+  /*!
+   * \brief Find the parsed parameter of a key.
+   * \return whether the key is found.
+   */
+  bool Find(const std::string& key, PType* param) const {
+    auto it = cache_.find(key);
+    if (it == cache_.end()) return false;
+    *param = it->second;
+    return true;
+  }
+  /*! \brief Insert the parsed parameter of a key. */
+  void Insert(const std::string& key, const PType& param) {
+    if (cache_.size() >= kMaxParamCacheSize) cache_.clear();
+    cache_.emplace(key, param);
+  }
+
+ private:
+  std::unordered_map<std::string, PType> cache_;
+};
+
 /*!
  * \brief Parse keyword arguments as PType arguments and save to parsed
+ *  Identical attribute dicts are parsed once, see ParamCache.
  * \tparam PType the parameter type.
  * \param attrs The attributes.
  */
 template<typename PType>
 inline void ParamParser(nnvm::NodeAttrs* attrs) {
   PType param;
+  ParamCache<PType>* cache = ParamCache<PType>::ThreadLocal();
+  std::string key = ParamCache<PType>::Key(attrs->dict);
+  if (cache->Find(key, &param)) {
+    attrs->parsed = std::move(param);
+    return;
+  }
   try {
     param.Init(attrs->dict);
   } catch (const dmlc::ParamError& e) {
@@ -36,6 +109,7 @@ inline void ParamParser(nnvm::NodeAttrs* attrs) {
     os << ")";
     throw dmlc::ParamError(os.str());
   }
+  cache->Insert(key, param);
   attrs->parsed = std::move(param);
 }
 
@@ -275,6 +349,31 @@ inline bool ZeroType(const NodeAttrs& attrs,
   return true;
 }
 
+// cost of one operation per output element
+inline uint64_t ElemwiseCost(const NodeAttrs& attrs,
+                             const std::vector<TShape>& ishapes,
+                             const std::vector<TShape>& oshapes) {
+  uint64_t flop = 0;
+  for (const TShape& s : oshapes) flop += s.Size();
+  return flop;
+}
+
+// cost of one operation per input element, for reductions
+inline uint64_t ReduceCost(const NodeAttrs& attrs,
+                           const std::vector<TShape>& ishapes,
+                           const std::vector<TShape>& oshapes) {
+  uint64_t flop = 0;
+  for (const TShape& s : ishapes) flop += s.Size();
+  return flop;
+}
+
+// zero cost of operators that only move data
+inline uint64_t ZeroCost(const NodeAttrs& attrs,
+                         const std::vector<TShape>& ishapes,
+                         const std::vector<TShape>& oshapes) {
+  return 0;
+}
+
 // Make zero grad node
 inline std::vector<NodeEntry> MakeZeroGradNodes(
   const NodePtr& n,
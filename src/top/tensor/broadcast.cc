@@ -13,6 +13,7 @@
 #include <nnvm/top/tensor.h>
 #include "../op_common.h"
 #include "../elemwise_op_common.h"
+#include "../layout_common.h"
 #include "topi/broadcast.h"
 
 namespace nnvm {
@@ -74,6 +75,7 @@ So with `shape=(2,0)`, we will obtain the same result as in the above example.
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<BroadcastToParam>)
 .set_attr<FInferShape>("FInferShape", BroadcastToInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
     const Array<Tensor>& inputs,
@@ -126,6 +128,49 @@ inline bool BinaryBroadcastShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+/*!
+ * \brief Binary broadcast can run in any layout of lhs as long as
+ *  rhs follows the layout of the trailing axes it is broadcast to,
+ *  e.g. a channel bias of shape (C, 1, 1) is requested in CHW16c
+ *  when lhs is in NCHW16c. rhs must cover the blocked axes of lhs,
+ *  a rhs of shape (H, W) does not support NCHW16c.
+ */
+inline bool BinaryBroadcastLayoutSupport(const NodeAttrs& attrs,
+                                         const std::vector<TShape>& ishapes,
+                                         std::vector<TLayoutInfo> *ilayouts,
+                                         std::vector<TLayoutInfo> *olayouts) {
+  const TShape& lhs = ishapes[0];
+  const TShape& rhs = ishapes[1];
+  const TLayoutInfo& layout = (*ilayouts)[0];
+  std::vector<LayoutAxis> axes;
+  if (!ParseLayout(layout, &axes) ||
+      PrimalLayout(layout).length() != lhs.ndim() ||
+      rhs.ndim() > lhs.ndim()) {
+    return false;
+  }
+  if (lhs == rhs) {
+    (*ilayouts)[1] = layout;
+  } else if (rhs.Size() == 1) {
+    (*ilayouts)[1] = "default";
+  } else {
+    std::string primal = PrimalLayout(layout);
+    dim_t offset = lhs.ndim() - rhs.ndim();
+    // rhs cannot align with the sub-axis of a blocked axis it does not cover.
+    for (dim_t i = 0; i < offset; ++i) {
+      if (LayoutSubFactor(axes, primal[i]) != 0) return false;
+    }
+    for (dim_t i = 0; i < rhs.ndim(); ++i) {
+      // the output must keep the shape of lhs
+      if (rhs[i] != lhs[i + offset] && rhs[i] != 1) return false;
+      int factor = LayoutSubFactor(axes, primal[i + offset]);
+      if (factor != 0 && rhs[i] % factor != 0) return false;
+    }
+    std::string sub_layout = SubLayout(axes, rhs.ndim());
+    (*ilayouts)[1] = (sub_layout == PrimalLayout(sub_layout) ? "default" : sub_layout);
+  }
+  (*olayouts)[0] = layout;
+  return true;
+}
 
 #define NNVM_REGISTER_BINARY_BROADCAST_OP(name)                     \
   NNVM_REGISTER_OP(name)                                            \
@@ -133,6 +178,9 @@ inline bool BinaryBroadcastShape(const nnvm::NodeAttrs& attrs,
   .set_num_outputs(1)                                               \
   .set_attr<FInferShape>("FInferShape", BinaryBroadcastShape)       \
   .set_attr<FInferType>("FInferType", ElemwiseType<2, 1>)           \
+  .set_attr<FEstimateCost>("FEstimateCost", ElemwiseCost)           \
+  .set_attr<FTVMLayoutSupport>("FTVMLayoutSupport",                 \
+                               BinaryBroadcastLayoutSupport)        \
   .set_attr<FInplaceOption>("FInplaceOption",                       \
     [](const NodeAttrs& attrs) {                                    \
       return std::vector<std::pair<int, int> >{{0, 0}, {1, 0}};     \
@@ -0,0 +1,135 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file layout_transform.cc
+ * \brief Layout transform operator.
+ */
+#include <nnvm/op.h>
+#include <nnvm/node.h>
+#include <nnvm/op_attr_types.h>
+#include <nnvm/compiler/op_attr_types.h>
+#include <nnvm/compiler/contrib_op_param.h>
+#include <utility>
+#include "../op_common.h"
+#include "../elemwise_op_common.h"
+#include "../layout_common.h"
+#include "topi/elemwise.h"
+#include "topi/tags.h"
+
+namespace nnvm {
+namespace compiler {
+DMLC_REGISTER_PARAMETER(LayoutTransformParam);
+}  // namespace compiler
+
+namespace top {
+using namespace tvm;
+using namespace nnvm::compiler;
+
+// The default layout refers to the primal layout of the other side.
+inline void GetTransformLayouts(const LayoutTransformParam& param,
+                                std::string* src,
+                                std::string* dst) {
+  *src = param.src_layout;
+  *dst = param.dst_layout;
+  if (*src == "default") *src = PrimalLayout(*dst);
+  if (*dst == "default") *dst = PrimalLayout(*src);
+}
+
+inline bool LayoutTransformInferShape(const NodeAttrs& attrs,
+                                      std::vector<TShape>* in_attrs,
+                                      std::vector<TShape>* out_attrs) {
+  CHECK_EQ(in_attrs->size(), 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  const TShape& dshape = (*in_attrs)[0];
+  if (dshape.ndim() == 0) return false;
+  const LayoutTransformParam& param = nnvm::get<LayoutTransformParam>(attrs.parsed);
+  std::string src, dst;
+  GetTransformLayouts(param, &src, &dst);
+  if (src == dst) {
+    NNVM_ASSIGN_OUTPUT_SHAPE(attrs, *out_attrs, 0, dshape);
+  } else {
+    NNVM_ASSIGN_OUTPUT_SHAPE(attrs, *out_attrs, 0,
+                             ConvertShapeLayout(dshape, src, dst));
+  }
+  return true;
+}
+
+NNVM_REGISTER_OP(layout_transform)
+.describe(R"code(Transform the input data layout.
+
+The layouts can block a primal axis by a factor, e.g. NCHW16c blocks
+the channel axis of NCHW by 16, so shape (1, 32, 8, 8) in NCHW is
+(1, 2, 8, 8, 16) in NCHW16c. The default layout refers to the primal
+layout of the other side.
+
+)code" NNVM_ADD_FILELINE)
+.add_argument("data", "Tensor", "Input data.")
+.add_arguments(LayoutTransformParam::__FIELDS__())
+.set_attr_parser(ParamParser<LayoutTransformParam>)
+.set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<LayoutTransformParam>)
+.set_attr<FInferShape>("FInferShape", LayoutTransformInferShape)
+.set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
+.set_attr<FTVMLayoutRequest>(
+  "FTVMLayoutRequest", [](const NodeAttrs& attrs,
+                          std::vector<TLayoutInfo> *ilayouts,
+                          std::vector<TLayoutInfo> *olayouts) {
+    const LayoutTransformParam& param = nnvm::get<LayoutTransformParam>(attrs.parsed);
+    (*ilayouts)[0] = param.src_layout;
+    (*olayouts)[0] = param.dst_layout;
+    return true;
+})
+.set_attr<FTVMCompute>(
+  "FTVMCompute", [](const NodeAttrs& attrs,
+                    const Array<Tensor>& inputs,
+                    const Array<Tensor>& out_info) {
+    const LayoutTransformParam& param = nnvm::get<LayoutTransformParam>(attrs.parsed);
+    std::string src, dst;
+    GetTransformLayouts(param, &src, &dst);
+    if (src == dst) {
+      return Array<Tensor>{ topi::identity(inputs[0]) };
+    }
+    std::vector<LayoutAxis> saxes, daxes;
+    CHECK(ParseLayout(src, &saxes)) << "Invalid layout " << src;
+    CHECK(ParseLayout(dst, &daxes)) << "Invalid layout " << dst;
+    const Tensor& data = inputs[0];
+    return Array<Tensor>{
+      tvm::compute(out_info[0]->shape, [&](const Array<Var>& indices) {
+        // coordinate of each primal axis
+        std::vector<std::pair<char, Expr> > coord;
+        for (size_t i = 0; i < daxes.size(); ++i) {
+          if (daxes[i].second != 0) continue;
+          int factor = LayoutSubFactor(daxes, daxes[i].first);
+          Expr index = indices[i];
+          coord.emplace_back(daxes[i].first, factor != 0 ? index * factor : index);
+        }
+        for (size_t i = 0; i < daxes.size(); ++i) {
+          if (daxes[i].second == 0) continue;
+          for (auto& c : coord) {
+            if (c.first == std::toupper(daxes[i].first)) c.second = c.second + indices[i];
+          }
+        }
+        Array<Expr> src_index;
+        for (size_t i = 0; i < saxes.size(); ++i) {
+          char axis = static_cast<char>(std::toupper(saxes[i].first));
+          Expr index;
+          for (const auto& c : coord) {
+            if (c.first == axis) index = c.second;
+          }
+          CHECK(index.defined())
+              << "Cannot convert layout " << src << " to " << dst;
+          if (saxes[i].second != 0) {
+            src_index.push_back(index % saxes[i].second);
+          } else {
+            int factor = LayoutSubFactor(saxes, saxes[i].first);
+            src_index.push_back(factor != 0 ? index / factor : index);
+          }
+        }
+        return data(src_index);
+      }, "tensor", topi::kInjective) };
+})
+.set_num_inputs(1)
+.set_num_outputs(1)
+.set_support_level(4);
+
+}  // namespace top
+}  // namespace nnvm
@@ -6,6 +6,7 @@
 #include <nnvm/op.h>
 #include <nnvm/node.h>
 #include <nnvm/op_attr_types.h>
+#include <nnvm/compiler/op_attr_types.h>
 #include <nnvm/top/tensor.h>
 #include "../op_common.h"
 #include "../elemwise_op_common.h"
@@ -13,6 +14,8 @@
 namespace nnvm {
 namespace top {
 
+using nnvm::compiler::FEstimateCost;
+
 DMLC_REGISTER_PARAMETER(MatMulParam);
 
 inline bool DotShape(const nnvm::NodeAttrs& attrs,
@@ -41,6 +44,17 @@ inline bool DotShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+// two operations per multiply-add over the last axis of lhs.
+inline uint64_t MatMulCost(const NodeAttrs& attrs,
+                           const std::vector<TShape>& ishapes,
+                           const std::vector<TShape>& oshapes) {
+  const MatMulParam& param = nnvm::get<MatMulParam>(attrs.parsed);
+  TShape lshape = ishapes[0];
+  if (lshape.ndim() == 1) lshape = TShape{1, lshape[0]};
+  uint64_t k = param.transpose_a ? lshape[0] : lshape[lshape.ndim() - 1];
+  return 2 * oshapes[0].Size() * k;
+}
+
 NNVM_REGISTER_OP(matmul)
   .describe(R"doc(Matrix multiplication of two arrays.
 
@@ -67,6 +81,7 @@ NNVM_REGISTER_OP(matmul)
 .add_argument("rhs", "NDArray-or-Symbol", "The second input")
 .set_attr<FInferShape>("FInferShape", DotShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", MatMulCost)
 .set_attr<FGradient>(
   "FGradient", [](const NodePtr& n,
                   const std::vector<NodeEntry>& ograds) {
@@ -111,6 +111,7 @@ inline void AxesParamParser(nnvm::NodeAttrs* attrs) {
   .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<ReduceParam>) \
   .set_attr<FInferShape>("FInferShape", ReduceShape)                    \
   .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)               \
+  .set_attr<FEstimateCost>("FEstimateCost", ReduceCost)                 \
   .set_num_inputs(1)                                                    \
   .set_num_outputs(1)
 
@@ -9,11 +9,14 @@
 #include <nnvm/compiler/op_attr_types.h>
 #include <nnvm/compiler/util.h>
 #include <nnvm/top/tensor.h>
+#include <tvm/ir.h>
 #include <cctype>
 #include "../op_common.h"
 #include "../elemwise_op_common.h"
+#include "../layout_common.h"
 #include "topi/nn/flatten.h"
 #include "topi/transform.h"
+#include "topi/tags.h"
 
 namespace nnvm {
 namespace top {
@@ -63,6 +66,7 @@ Example::
 .set_num_outputs(1)
 .set_attr<FInferShape>("FInferShape", FlattenInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .add_argument("data", "Tensor", "Input data.")
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
@@ -119,6 +123,35 @@ inline bool ConcatenateInferShape(const NodeAttrs& attrs,
   return dshape.Size() != 0;
 }
 
+// concatenate along a primal axis works in layouts where the sub-axes
+// are appended after the primal axes, e.g. NCHW16c, if every input is
+// evenly blocked on the concatenated axis.
+inline bool ConcatenateLayoutSupport(const NodeAttrs& attrs,
+                                     const std::vector<TShape>& ishapes,
+                                     std::vector<TLayoutInfo> *ilayouts,
+                                     std::vector<TLayoutInfo> *olayouts) {
+  const ConcatenateParam& param = nnvm::get<ConcatenateParam>(attrs.parsed);
+  const TLayoutInfo& layout = (*ilayouts)[0];
+  std::vector<LayoutAxis> axes;
+  if (!ParseLayout(layout, &axes)) return false;
+  std::string primal = PrimalLayout(layout);
+  if (primal.length() != ishapes[0].ndim() ||
+      static_cast<size_t>(param.axis) >= primal.length()) {
+    return false;
+  }
+  for (size_t i = 0; i < primal.length(); ++i) {
+    if (axes[i].second != 0) return false;
+  }
+  int factor = LayoutSubFactor(axes, primal[param.axis]);
+  for (const TShape& shape : ishapes) {
+    if (shape.ndim() != primal.length()) return false;
+    if (factor != 0 && shape[param.axis] % factor != 0) return false;
+  }
+  for (TLayoutInfo& l : *ilayouts) l = layout;
+  (*olayouts)[0] = layout;
+  return true;
+}
+
 NNVM_REGISTER_OP(concatenate)
 .describe(R"code(Joins input arrays along a given axis.
 
@@ -155,7 +188,9 @@ Example::
 .set_attr_parser(ParamParser<ConcatenateParam>)
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<ConcatenateParam>)
 .set_attr<FInferShape>("FInferShape", ConcatenateInferShape)
+.set_attr<FTVMLayoutSupport>("FTVMLayoutSupport", ConcatenateLayoutSupport)
 .set_attr<FInferType>("FInferType", ElemwiseType<-1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_attr<FTVMCompute>(
   "FTVMCompute", [](const NodeAttrs& attrs,
                     const Array<Tensor>& inputs,
@@ -207,6 +242,7 @@ will return a new array with shape ``(2,5,3,4)``.
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<ExpandDimsParam>)
 .set_attr<FInferShape>("FInferShape", ExpandDimsInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_inputs(1)
 .set_num_outputs(1)
 .set_attr<FTVMCompute>(
@@ -249,6 +285,7 @@ Examples::
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<IndicatorParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", AssignOutputAttr<TShape, 1, 0>)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_inputs(2)
 .set_num_outputs(1)
 .set_attr<FGradient>(
@@ -345,6 +382,7 @@ along which to split the array.
 .set_attr_parser(SplitParamParser)
 .set_attr<FInferShape>("FInferShape", SplitInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, -1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_inputs(1)
 .set_num_outputs(SplitNumOutputs)
 .set_attr<FTVMCompute>(
@@ -387,10 +425,73 @@ NNVM_REGISTER_OP(cast)
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<CastParam>)
 .set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 1>)
 .set_attr<FInferType>("FInferType", CastInferType)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
+.set_attr<FTVMCompute>(
+  "FTVMCompute", [](const NodeAttrs& attrs,
+                    const Array<Tensor>& inputs,
+                    const Array<Tensor>& out_info) {
+    const Tensor& x = inputs[0];
+    const Type& dtype = out_info[0]->dtype;
+    return Array<Tensor>{
+      tvm::compute(x->shape, [&](const Array<Var>& i) {
+        return tvm::cast(dtype, x(i));
+      }, "tensor", topi::kElementWise) };
+})
 .set_num_inputs(1)
 .set_num_outputs(1)
 .set_support_level(1);
 
+// quantize
+DMLC_REGISTER_PARAMETER(QuantizeParam);
+
+inline bool QuantizeInferType(const NodeAttrs& attrs,
+                              std::vector<int>* in_attrs,
+                              std::vector<int>* out_attrs) {
+  const QuantizeParam& param = nnvm::get<QuantizeParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  NNVM_ASSIGN_OUTPUT_TYPE(attrs, *out_attrs, 0, param.out_dtype);
+  return (*in_attrs)[0] != -1;
+}
+
+NNVM_REGISTER_OP(quantize)
+.describe(R"code(Quantize the input to a signed integer type.
+
+The input is divided by scale, clipped symmetrically to the range of
+out_dtype, i.e. [-127, 127] for int8, and rounded to the nearest integer.
+
+)code" NNVM_ADD_FILELINE)
+.add_argument("data", "Tensor", "Input data array")
+.add_arguments(QuantizeParam::__FIELDS__())
+.set_attr_parser(ParamParser<QuantizeParam>)
+.set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<QuantizeParam>)
+.set_attr<FInferShape>("FInferShape", ElemwiseShape<1, 1>)
+.set_attr<FInferType>("FInferType", QuantizeInferType)
+.set_attr<FEstimateCost>("FEstimateCost", ElemwiseCost)
+.set_attr<FTVMCompute>(
+  "FTVMCompute", [](const NodeAttrs& attrs,
+                    const Array<Tensor>& inputs,
+                    const Array<Tensor>& out_info) {
+    const QuantizeParam& param = nnvm::get<QuantizeParam>(attrs.parsed);
+    const Tensor& x = inputs[0];
+    const Type& dtype = out_info[0]->dtype;
+    double qmax = static_cast<double>((int64_t(1) << (dtype.bits() - 1)) - 1);
+    return Array<Tensor>{
+      tvm::compute(x->shape, [&](const Array<Var>& i) {
+        Expr v = x(i) / make_const(x->dtype, param.scale);
+        v = tvm::max(tvm::min(v, make_const(x->dtype, qmax)),
+                     make_const(x->dtype, -qmax));
+        // round half away from zero, the cast truncates.
+        v = ir::Select::make(v >= make_zero(x->dtype),
+                             v + make_const(x->dtype, 0.5),
+                             v - make_const(x->dtype, 0.5));
+        return tvm::cast(dtype, v);
+      }, "tensor", topi::kElementWise) };
+})
+.set_num_inputs(1)
+.set_num_outputs(1)
+.set_support_level(4);
+
 
 // reshape
 DMLC_REGISTER_PARAMETER(ReshapeParam);
@@ -539,6 +640,7 @@ The significance of each is explained below:
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<ReshapeParam>)
 .set_attr<FInferShape>("FInferShape", ReshapeInferShape)
 .set_attr<FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_inputs(1)
 .set_num_outputs(1)
 .set_attr<FTVMCompute>(
@@ -578,6 +680,7 @@ the input array into an output array with the same shape as the second input arr
     return true;
 })
 .set_attr<FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_attr<FGradient>(
   "FGradient", [](const NodePtr& n,
                   const std::vector<NodeEntry>& ograds) {
@@ -660,6 +763,7 @@ Examples::
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<SqueezeParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", SqueezeShape)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_inputs(1)
 .set_num_outputs(1)
 .set_attr<FTVMCompute>(
@@ -743,6 +847,7 @@ Examples::
 .set_attr<FGetAttrDict>("FGetAttrDict", ParamGetAttrDict<TransposeParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", TransposeShape)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FEstimateCost>("FEstimateCost", ZeroCost)
 .set_num_inputs(1)
 .set_num_outputs(1)
 .set_support_level(4)
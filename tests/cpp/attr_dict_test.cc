@@ -0,0 +1,48 @@
+#include <dmlc/logging.h>
+#include <gtest/gtest.h>
+#include <nnvm/attr_dict.h>
+#include <nnvm/node.h>
+#include <sstream>
+#include <type_traits>
+
+TEST(CompactAttrDict, Basic) {
+  using nnvm::CompactAttrDict;
+  std::unordered_map<std::string, std::string> kwargs{{"b", "2"}, {"a", "1"}};
+  CompactAttrDict dict = kwargs;
+  dict["c"] = "3";
+  CHECK_EQ(dict.size(), 3);
+  CHECK_EQ(dict.begin()->first, "a");
+  CHECK(!dict.emplace("a", "0").second);
+  CHECK_EQ(dict.at("a"), "1");
+  CHECK(dict.find("d") == dict.end());
+  CHECK_EQ(dict.erase("b"), 1);
+  CHECK_EQ(dict.count("b"), 0);
+  std::unordered_map<std::string, std::string> copy = dict;
+  CHECK_EQ(copy.size(), 2);
+  CHECK_EQ(copy.at("c"), "3");
+}
+
+TEST(CompactAttrDict, NodeAttrs) {
+  static_assert(std::is_same<decltype(nnvm::NodeAttrs::dict),
+                             nnvm::CompactAttrDict>::value,
+                "NodeAttrs::dict is a CompactAttrDict");
+  nnvm::NodeAttrs attrs;
+  attrs.dict["units"] = "16";
+  attrs.dict["axis"] = "1";
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.Write(attrs.dict);
+  // the keys are written in order.
+  CHECK_LT(os.str().find("axis"), os.str().find("units"));
+  std::istringstream is(os.str());
+  dmlc::JSONReader reader(&is);
+  nnvm::CompactAttrDict loaded;
+  reader.Read(&loaded);
+  CHECK(loaded == attrs.dict);
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
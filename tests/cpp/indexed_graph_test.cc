@@ -0,0 +1,91 @@
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <gtest/gtest.h>
+#include <nnvm/graph.h>
+#include <unordered_map>
+
+namespace {
+
+// build a graph of n nodes, each taking the two previous nodes as inputs.
+nnvm::Graph MakeGraph(size_t n) {
+  std::vector<nnvm::NodePtr> nodes;
+  nodes.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    nnvm::NodePtr p = nnvm::Node::Create();
+    for (size_t j = 1; j <= 2 && j <= i; ++j) {
+      p->inputs.emplace_back(nnvm::NodeEntry{nodes[i - j], 0, 0});
+    }
+    nodes.emplace_back(std::move(p));
+  }
+  nnvm::Graph g;
+  g.outputs.emplace_back(nnvm::NodeEntry{nodes.back(), 0, 0});
+  return g;
+}
+
+}  // namespace
+
+TEST(IndexedGraph, NodeId) {
+  nnvm::Graph g = MakeGraph(1000);
+  const nnvm::IndexedGraph& idx = g.indexed_graph();
+  CHECK_EQ(idx.num_nodes(), 1000);
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    CHECK_EQ(idx.node_id(idx[nid].source), nid);
+    CHECK(idx.exist(idx[nid].source));
+  }
+  nnvm::NodePtr other = nnvm::Node::Create();
+  CHECK(!idx.exist(other.get()));
+  EXPECT_THROW(idx.node_id(other.get()), dmlc::Error);
+  CHECK(!idx.exist(nullptr));
+  EXPECT_THROW(idx.node_id(nullptr), dmlc::Error);
+}
+
+TEST(IndexedGraph, NodeIndexMapNull) {
+  nnvm::NodeIndexMap map;
+  CHECK_EQ(map.Find(nullptr), nnvm::NodeIndexMap::kNotFound);
+  nnvm::NodePtr n = nnvm::Node::Create();
+  map.Insert(n.get(), 0);
+  // the empty slots must not match nullptr.
+  CHECK_EQ(map.Find(nullptr), nnvm::NodeIndexMap::kNotFound);
+  CHECK_EQ(map.Find(n.get()), 0);
+}
+
+TEST(IndexedGraph, Benchmark) {
+  // about 1M edges
+  const size_t num_nodes = 500000;
+  nnvm::Graph g = MakeGraph(num_nodes);
+  double tstart = dmlc::GetTime();
+  const nnvm::IndexedGraph& idx = g.indexed_graph();
+  double tbuild = dmlc::GetTime();
+  size_t sum = 0;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    for (const nnvm::NodeEntry& e : idx[nid].source->inputs) {
+      sum += idx.entry_id(e);
+    }
+  }
+  double tlookup = dmlc::GetTime();
+  // the same lookups with the hash map used before.
+  std::unordered_map<const nnvm::Node*, uint32_t> node2index;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    node2index[idx[nid].source] = nid;
+  }
+  double tmap_build = dmlc::GetTime();
+  size_t map_sum = 0;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    for (const nnvm::NodeEntry& e : idx[nid].source->inputs) {
+      map_sum += idx.entry_id(node2index.at(e.node.get()), e.index);
+    }
+  }
+  double tmap_lookup = dmlc::GetTime();
+  CHECK_EQ(sum, map_sum);
+  LOG(INFO) << "IndexedGraph of " << num_nodes << " nodes: build "
+            << (tbuild - tstart) * 1000 << " ms, edge lookups "
+            << (tlookup - tbuild) * 1000 << " ms; unordered_map insert "
+            << (tmap_build - tlookup) * 1000 << " ms, edge lookups "
+            << (tmap_lookup - tmap_build) * 1000 << " ms";
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+#include <dmlc/logging.h>
+#include <dmlc/timer.h>
+#include <gtest/gtest.h>
+#include <nnvm/graph.h>
+#include <nnvm/node.h>
+#include <nnvm/op.h>
+#include <nnvm/symbolic.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// track the bytes allocated by operator new, to measure the retained memory.
+namespace {
+std::atomic<int64_t> live_bytes{0};
+constexpr size_t kAllocHeader = alignof(std::max_align_t);
+}  // namespace
+
+void* operator new(size_t size) {
+  char* p = static_cast<char*>(std::malloc(size + kAllocHeader));
+  if (p == nullptr) throw std::bad_alloc();
+  *reinterpret_cast<size_t*>(p) = size;
+  live_bytes += size;
+  return p + kAllocHeader;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) return;
+  char* p = static_cast<char*>(ptr) - kAllocHeader;
+  live_bytes -= *reinterpret_cast<size_t*>(p);
+  std::free(p);
+}
+
+NNVM_REGISTER_OP(arena_add)
+.set_num_inputs(2);
+
+namespace {
+
+// build a graph of n nodes, each taking the two previous nodes as inputs.
+std::vector<nnvm::NodeEntry> MakeGraph(size_t n) {
+  std::vector<nnvm::NodePtr> nodes;
+  nodes.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    nnvm::NodePtr p = nnvm::Node::Create();
+    p->attrs.name = "node" + std::to_string(i);
+    for (size_t j = 1; j <= 2 && j <= i; ++j) {
+      p->inputs.emplace_back(nnvm::NodeEntry{nodes[i - j], 0, 0});
+    }
+    nodes.emplace_back(std::move(p));
+  }
+  return {nnvm::NodeEntry{nodes.back(), 0, 0}};
+}
+
+size_t CountNodes(const std::vector<nnvm::NodeEntry>& outputs) {
+  size_t count = 0;
+  nnvm::DFSVisit(outputs, [&count](const nnvm::NodePtr& n) { ++count; });
+  return count;
+}
+
+}  // namespace
+
+TEST(NodeArena, Basic) {
+  std::vector<nnvm::NodeEntry> outputs;
+  {
+    nnvm::NodeArenaScope scope;
+    outputs = MakeGraph(3000);
+  }
+  // the nodes outlive the scope.
+  CHECK_EQ(CountNodes(outputs), 3000);
+  CHECK_EQ(outputs[0].node->inputs.size(), 2);
+  {
+    nnvm::NodeArenaScope scope;
+    nnvm::NodeArenaScope inner;
+    std::vector<nnvm::NodeEntry> other = MakeGraph(10);
+    outputs = other;
+  }
+  CHECK_EQ(CountNodes(outputs), 10);
+}
+
+TEST(NodeArena, VariableRetention) {
+  const size_t num_nodes = 20000;
+  const nnvm::Op* add = nnvm::Op::Get("arena_add");
+  nnvm::Symbol sym;
+  {
+    nnvm::NodePtr x = nnvm::Symbol::CreateVariable("x").outputs[0].node;
+    nnvm::NodePtr w = nnvm::Symbol::CreateVariable("w").outputs[0].node;
+    nnvm::NodeEntry y{x, 0, 0};
+    for (size_t i = 0; i < num_nodes; ++i) {
+      nnvm::NodePtr p = nnvm::Node::Create();
+      p->attrs.op = add;
+      p->attrs.name = "add" + std::to_string(i);
+      p->inputs = {y, nnvm::NodeEntry{w, 0, 0}};
+      y = nnvm::NodeEntry{p, 0, 0};
+    }
+    sym.outputs.push_back(y);
+  }
+  int64_t before = live_bytes;
+  std::vector<nnvm::NodePtr> vars;
+  {
+    // the copy is allocated in an arena, only its variables are kept.
+    nnvm::Symbol copy = sym.Copy();
+    vars = copy.ListInputs(nnvm::Symbol::kAll);
+  }
+  int64_t retained = live_bytes - before;
+  LOG(INFO) << "retained " << retained << " bytes by " << vars.size()
+            << " variables of a copied graph of " << num_nodes << " nodes";
+  CHECK_EQ(vars.size(), 2);
+  // the variables do not pin a page of the arena.
+  CHECK_LT(retained, static_cast<int64_t>(sizeof(nnvm::Node) * 64));
+}
+
+TEST(NodeArena, SmallScope) {
+  std::vector<nnvm::NodeEntry> outputs;
+  int64_t before = live_bytes;
+  {
+    nnvm::NodeArenaScope scope;
+    outputs = MakeGraph(2);
+  }
+  int64_t retained = live_bytes - before;
+  LOG(INFO) << "retained " << retained << " bytes by a graph of 2 nodes";
+  CHECK_EQ(CountNodes(outputs), 2);
+  // a small scope only allocates a small page.
+  CHECK_LT(retained, static_cast<int64_t>(sizeof(nnvm::Node) * 64));
+}
+
+TEST(NodeArena, Benchmark) {
+  const size_t num_nodes = 200000;
+  const int repeat = 5;
+  for (bool use_arena : {false, true}) {
+    double create = 0, visit = 0, destroy = 0;
+    for (int i = 0; i < repeat; ++i) {
+      std::unique_ptr<nnvm::NodeArenaScope> scope;
+      if (use_arena) scope.reset(new nnvm::NodeArenaScope());
+      double tstart = dmlc::GetTime();
+      std::vector<nnvm::NodeEntry> outputs = MakeGraph(num_nodes);
+      double tcreate = dmlc::GetTime();
+      CHECK_EQ(CountNodes(outputs), num_nodes);
+      double tvisit = dmlc::GetTime();
+      outputs.clear();
+      double tdestroy = dmlc::GetTime();
+      create += tcreate - tstart;
+      visit += tvisit - tcreate;
+      destroy += tdestroy - tvisit;
+    }
+    LOG(INFO) << (use_arena ? "arena" : "make_shared") << ": "
+              << num_nodes << " nodes, create " << create / repeat * 1000
+              << " ms, dfs " << visit / repeat * 1000
+              << " ms, destroy " << destroy / repeat * 1000 << " ms";
+  }
+}
+
+int main(int argc, char ** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
@@ -1,7 +1,7 @@
 import numpy as np
 
 import tvm
-from tvm.contrib import graph_runtime
+from tvm.contrib import graph_runtime, util
 import nnvm.symbol as sym
 import nnvm.compiler
 from nnvm.compiler.build_module import _run_graph, precompute_prune
@@ -77,6 +77,31 @@ def test_precompute_prune():
         res.asnumpy(), nx.asnumpy() + 1 + ny.asnumpy() + na.asnumpy())
 
 
+def test_bundle():
+    x = sym.Variable("x") + 1
+    a = sym.Variable("a")
+    y = sym.Variable("y")
+    z = y + x + a
+    shape = (10, 10)
+    dtype = tvm.float32
+    nx = tvm.nd.array(np.random.uniform(size=shape).astype(dtype))
+    na = tvm.nd.array(np.random.uniform(size=shape).astype(dtype))
+    ny = tvm.nd.array(np.random.uniform(size=shape).astype(dtype))
+    temp = util.tempdir()
+    path = temp.relpath("deploy.bundle")
+    nnvm.compiler.build(z, "llvm", shape={"y": ny.shape},
+                        params={"x": nx, "a": na}, bundle=path)
+    graph, lib, params = nnvm.compiler.load_bundle(path)
+    m = graph_runtime.create(graph, lib, tvm.cpu(0))
+    m.set_input(**params)
+    m.run(y=ny)
+    out = m.get_output(0, tvm.nd.empty(shape))
+    np.testing.assert_allclose(
+        out.asnumpy(), nx.asnumpy() + 1 + ny.asnumpy() + na.asnumpy())
+    _, _, _, texts = nnvm.compiler.load_bundle(path, sections=["missing"])
+    assert texts == {"missing": None}
+
+
 def test_dtypes():
     x = sym.Variable("x")
     y = sym.relu(x)
@@ -97,6 +122,7 @@ def test_dtypes():
 
 if __name__ == "__main__":
     test_precompute_prune()
+    test_bundle()
     test_compile()
     test_run()
     test_dtypes()
@@ -51,6 +51,130 @@ def test_fold_axis_conv():
     check((2, 4, 10, 10), 2)
 
 
+def test_fold_axis_depthwise_conv():
+    def before(x, conv_weight, conv_bias, in_scale, out_scale, channels):
+        x = x * sym.expand_dims(in_scale, axis=1, num_newaxis=2)
+        y = sym.conv2d(x, conv_weight, conv_bias,
+                       channels=channels,
+                       kernel_size=(3, 3),
+                       padding=(1, 1),
+                       groups=channels,
+                       name="conv")
+        y = sym.relu(y)
+        y = y * sym.expand_dims(out_scale, axis=1, num_newaxis=2)
+        return y
+
+    def expected(x, conv_weight, conv_bias, in_scale, out_scale, channels):
+        conv_weight = conv_weight * sym.expand_dims(out_scale, axis=1, num_newaxis=3)
+        conv_weight = conv_weight * sym.expand_dims(in_scale, axis=1, num_newaxis=3)
+        conv_bias = conv_bias * out_scale
+        y = sym.conv2d(x,
+                       conv_weight,
+                       conv_bias,
+                       channels=channels,
+                       kernel_size=(3, 3),
+                       padding=(1, 1),
+                       groups=channels,
+                       name="conv")
+        y = sym.relu(y)
+        return y
+
+    def check(shape, channels):
+        x = sym.Variable("x") + 1
+        weight = sym.Variable("weight")
+        bias = sym.Variable("bias")
+        in_scale = sym.Variable("in_scale")
+        out_scale = sym.Variable("out_scale")
+        y1 = before(x, weight, bias, in_scale, out_scale, channels)
+        y2 = expected(x, weight, bias, in_scale, out_scale, channels)
+        ishape = {"x": shape, "out_scale": (channels,), "in_scale": (shape[1],)}
+        g1 = nnvm.graph.create(y1)
+        g2 = nnvm.graph.create(y2)
+        graph_attr.set_shape_inputs(g1, ishape)
+        g1 = g1.apply("InferShape").apply("FoldScaleAxis")
+        graph_util.check_graph_equal(g1, g2)
+
+    check((2, 4, 10, 10), 4)
+
+
+def test_fold_axis_conv_transpose():
+    def before(x, conv_weight, conv_bias, in_scale, out_scale, channels):
+        x = x * sym.expand_dims(in_scale, axis=1, num_newaxis=2)
+        y = sym.conv2d_transpose(x, conv_weight, conv_bias,
+                                 channels=channels,
+                                 kernel_size=(3, 3),
+                                 padding=(1, 1),
+                                 name="conv")
+        y = sym.relu(y)
+        y = y * sym.expand_dims(out_scale, axis=1, num_newaxis=2)
+        return y
+
+    def expected(x, conv_weight, conv_bias, in_scale, out_scale, channels):
+        conv_weight = conv_weight * sym.expand_dims(out_scale, axis=1, num_newaxis=2)
+        conv_weight = conv_weight * sym.expand_dims(in_scale, axis=1, num_newaxis=3)
+        conv_bias = conv_bias * out_scale
+        y = sym.conv2d_transpose(x,
+                                 conv_weight,
+                                 conv_bias,
+                                 channels=channels,
+                                 kernel_size=(3, 3),
+                                 padding=(1, 1),
+                                 name="conv")
+        y = sym.relu(y)
+        return y
+
+    def check(shape, channels):
+        x = sym.Variable("x") + 1
+        weight = sym.Variable("weight")
+        bias = sym.Variable("bias")
+        in_scale = sym.Variable("in_scale")
+        out_scale = sym.Variable("out_scale")
+        y1 = before(x, weight, bias, in_scale, out_scale, channels)
+        y2 = expected(x, weight, bias, in_scale, out_scale, channels)
+        ishape = {"x": shape, "out_scale": (channels,), "in_scale": (shape[1],)}
+        g1 = nnvm.graph.create(y1)
+        g2 = nnvm.graph.create(y2)
+        graph_attr.set_shape_inputs(g1, ishape)
+        g1 = g1.apply("InferShape").apply("FoldScaleAxis")
+        graph_util.check_graph_equal(g1, g2)
+
+    check((2, 4, 10, 10), 2)
+
+
+def test_fold_axis_dense():
+    def before(x, weight, bias, in_scale, out_scale, units):
+        x = x * in_scale
+        y = sym.dense(x, weight, bias, units=units, name="dense")
+        y = sym.relu(y)
+        y = y * out_scale
+        return y
+
+    def expected(x, weight, bias, in_scale, out_scale, units):
+        weight = weight * sym.expand_dims(out_scale, axis=1, num_newaxis=1)
+        weight = weight * in_scale
+        bias = bias * out_scale
+        y = sym.dense(x, weight, bias, units=units, name="dense")
+        y = sym.relu(y)
+        return y
+
+    def check(shape, units):
+        x = sym.Variable("x") + 1
+        weight = sym.Variable("weight")
+        bias = sym.Variable("bias")
+        in_scale = sym.Variable("in_scale")
+        out_scale = sym.Variable("out_scale")
+        y1 = before(x, weight, bias, in_scale, out_scale, units)
+        y2 = expected(x, weight, bias, in_scale, out_scale, units)
+        ishape = {"x": shape, "out_scale": (units,), "in_scale": (shape[1],)}
+        g1 = nnvm.graph.create(y1)
+        g2 = nnvm.graph.create(y2)
+        graph_attr.set_shape_inputs(g1, ishape)
+        g1 = g1.apply("InferShape").apply("FoldScaleAxis")
+        graph_util.check_graph_equal(g1, g2)
+
+    check((2, 10), 4)
+
+
 def test_fold_fail():
     def before(x, scale, channels):
         y = sym.conv2d(x,
@@ -76,6 +200,18 @@ def test_fold_fail():
 
     check((2, 10, 10, 10), 10)
 
+    # input scale of grouped conv cannot be folded unless depthwise.
+    x = sym.Variable("x") + 1
+    weight = sym.Variable("weight")
+    scale = sym.Variable("scale")
+    y = x * sym.expand_dims(scale, axis=1, num_newaxis=2)
+    y = sym.conv2d(y, weight, channels=4, kernel_size=(3, 3),
+                   groups=2, use_bias=False, name="conv")
+    g1 = nnvm.graph.create(y)
+    graph_attr.set_shape_inputs(g1, {"x": (2, 4, 10, 10), "scale": (4,)})
+    g2 = g1.apply("InferShape").apply("FoldScaleAxis")
+    graph_util.check_graph_equal(g1, g2)
+
 
 def test_fold_resnet():
     batch_size = 1
@@ -107,4 +243,7 @@ def test_fold_resnet():
 if __name__ == "__main__":
     test_fold_resnet()
     test_fold_axis_conv()
+    test_fold_axis_depthwise_conv()
+    test_fold_axis_conv_transpose()
+    test_fold_axis_dense()
     test_fold_fail()
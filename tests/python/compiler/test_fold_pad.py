@@ -0,0 +1,96 @@
+"""Unittest cases for fold_pad"""
+import numpy as np
+
+import tvm
+from tvm.contrib import graph_runtime
+import nnvm
+import nnvm.compiler
+from nnvm import symbol as sym
+from nnvm.compiler import graph_util
+from nnvm.testing.config import ctx_list
+
+
+def test_fold_pad_conv():
+    def before(x, w):
+        x = sym.pad(x, pad_width=((0, 0), (0, 0), (1, 1), (2, 2)))
+        return sym.conv2d(x, w, channels=4, kernel_size=(3, 3),
+                          padding=(1, 0), use_bias=False, name="conv")
+
+    def expected(x, w):
+        return sym.conv2d(x, w, channels=4, kernel_size=(3, 3),
+                          padding=(2, 2), use_bias=False, name="conv")
+
+    x = sym.Variable("x")
+    w = sym.Variable("w")
+    g1 = nnvm.graph.create(before(x, w)).apply("FoldPad")
+    g2 = nnvm.graph.create(expected(x, w))
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_fold_pad_pool():
+    x = sym.Variable("x")
+    y = sym.pad(x, pad_width=((0, 0), (1, 1), (1, 1), (0, 0)))
+    y = sym.avg_pool2d(y, pool_size=(2, 2), layout="NHWC", name="pool")
+    g1 = nnvm.graph.create(y).apply("FoldPad")
+    y = sym.avg_pool2d(x, pool_size=(2, 2), padding=(1, 1), layout="NHWC", name="pool")
+    g2 = nnvm.graph.create(y)
+    graph_util.check_graph_equal(g1, g2)
+
+    # max pooling does not treat zero padding as implicit padding
+    y = sym.pad(x, pad_width=((0, 0), (0, 0), (1, 1), (1, 1)))
+    y = sym.max_pool2d(y, pool_size=(2, 2), name="pool")
+    g1 = nnvm.graph.create(y)
+    g2 = g1.apply("FoldPad")
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_fold_pad_fail():
+    x = sym.Variable("x")
+    w = sym.Variable("w")
+    # asymmetric padding cannot be folded
+    y = sym.pad(x, pad_width=((0, 0), (0, 0), (0, 1), (0, 1)))
+    y = sym.conv2d(y, w, channels=4, kernel_size=(3, 3), use_bias=False)
+    g1 = nnvm.graph.create(y)
+    graph_util.check_graph_equal(g1, g1.apply("FoldPad"))
+    # the padded result is used by another node
+    p = sym.pad(x, pad_width=((0, 0), (0, 0), (1, 1), (1, 1)))
+    y = sym.conv2d(p, w, channels=4, kernel_size=(3, 3), use_bias=False)
+    g1 = nnvm.graph.create(sym.Group([y, p]))
+    graph_util.check_graph_equal(g1, g1.apply("FoldPad"))
+
+
+def test_fuse_asymmetric_pad():
+    # keras 'same' padding with stride 2 pads one more row and column after.
+    x = sym.Variable("x")
+    w = sym.Variable("w")
+    y = sym.pad(x, pad_width=((0, 0), (0, 0), (0, 1), (0, 1)))
+    y = sym.conv2d(y, w, channels=4, kernel_size=(3, 3), strides=(2, 2),
+                   use_bias=False, name="conv")
+    y = sym.relu(y)
+    dshape = (1, 3, 8, 8)
+    wshape = (4, 3, 3, 3)
+    oshape = (1, 4, 4, 4)
+    data = np.random.uniform(size=dshape).astype("float32")
+    weight = np.random.uniform(size=wshape).astype("float32")
+    padded = np.pad(data, ((0, 0), (0, 0), (0, 1), (0, 1)), "constant")
+    expected = np.zeros(oshape, dtype="float32")
+    for i in range(4):
+        for j in range(4):
+            window = padded[0, :, 2 * i:2 * i + 3, 2 * j:2 * j + 3]
+            expected[0, :, i, j] = np.tensordot(weight, window, axes=3)
+    expected = np.maximum(expected, 0)
+    for target, ctx in ctx_list():
+        graph, lib, _ = nnvm.compiler.build(y, target, {"x": dshape, "w": wshape})
+        # the pad is fused with the convolution and relu
+        assert graph.index.num_nodes == 3
+        m = graph_runtime.create(graph, lib, ctx)
+        m.run(x=data, w=weight)
+        out = m.get_output(0, tvm.nd.empty(oshape))
+        np.testing.assert_allclose(out.asnumpy(), expected, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_fold_pad_conv()
+    test_fold_pad_pool()
+    test_fold_pad_fail()
+    test_fuse_asymmetric_pad()
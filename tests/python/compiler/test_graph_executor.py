@@ -0,0 +1,51 @@
+import numpy as np
+
+import tvm
+from tvm.contrib import graph_runtime
+import nnvm.symbol as sym
+import nnvm.compiler
+from nnvm.compiler import graph_executor
+
+
+def test_graph_executor():
+    x = sym.Variable("x")
+    y1 = sym.relu(sym.dense(x, units=16, name="fc1"))
+    y2 = sym.sigmoid(sym.dense(x, units=16, name="fc2"))
+    z = sym.elemwise_add(y1, y2)
+    shape = {"x": (4, 8)}
+    params = {
+        "fc1_weight": np.random.uniform(size=(16, 8)).astype("float32"),
+        "fc1_bias": np.random.uniform(size=(16,)).astype("float32"),
+        "fc2_weight": np.random.uniform(size=(16, 8)).astype("float32"),
+        "fc2_bias": np.random.uniform(size=(16,)).astype("float32"),
+    }
+    data = np.random.uniform(size=shape["x"]).astype("float32")
+    h1 = np.maximum(data.dot(params["fc1_weight"].T) + params["fc1_bias"], 0)
+    h2 = 1 / (1 + np.exp(-(data.dot(params["fc2_weight"].T) + params["fc2_bias"])))
+    expected = h1 + h2
+
+    def verify(graph, lib, num_threads):
+        m = graph_executor.create(graph, lib, tvm.cpu(0), num_threads=num_threads)
+        m.set_input(**params)
+        for _ in range(3):
+            m.run(x=data)
+            out = m.get_output(0)
+            np.testing.assert_allclose(out.asnumpy(), expected, rtol=1e-5)
+        # same as the graph runtime
+        r = graph_runtime.create(graph, lib, tvm.cpu(0))
+        r.set_input(x=data, **params)
+        r.run()
+        np.testing.assert_allclose(
+            out.asnumpy(), r.get_output(0, tvm.nd.empty((4, 16))).asnumpy(), rtol=1e-5)
+
+    with nnvm.compiler.build_config(num_streams=2):
+        graph, lib, _ = nnvm.compiler.build(z, "llvm", shape)
+    assert "node_level" in graph.json()
+    verify(graph, lib, 4)
+    verify(graph, lib, 1)
+    graph, lib, _ = nnvm.compiler.build(z, "llvm", shape)
+    verify(graph, lib, 4)
+
+
+if __name__ == "__main__":
+    test_graph_executor()
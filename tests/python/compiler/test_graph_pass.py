@@ -14,5 +14,27 @@ def test_infer_attr():
     itype, otype = graph_util.infer_dtype(g, x="float32")
     assert otype[0] == "float32"
 
+def test_estimate_cost():
+    x = sym.Variable("x")
+    y = sym.conv2d(x, channels=8, kernel_size=(3, 3), padding=(1, 1),
+                   use_bias=False, name="conv")
+    y = sym.relu(y, name="relu")
+    y = sym.flatten(y, name="flatten")
+    g = nnvm.graph.create(y)
+    cost = graph_util.estimate_cost(g, {"x": (1, 4, 8, 8)})
+    nodes = {n[0]: n for n in cost["nodes"]}
+    out_size = 8 * 8 * 8
+    assert nodes["conv"][2] == 2 * out_size * 4 * 9
+    assert nodes["conv"][3] == (4 * 8 * 8 + 8 * 4 * 9) * 4
+    assert nodes["conv"][4] == out_size * 4
+    assert nodes["relu"][2] == out_size
+    assert nodes["flatten"][2] == 0
+    assert cost["flop"] == 2 * out_size * 4 * 9 + out_size
+    assert cost["arithmetic_intensity"] > 0
+    g = g.apply(["InferShape", "InferType", "EstimateCost"])
+    ir = g.ir(join_node_attrs=["flop"])
+    assert "flop=%d" % out_size in ir
+
 if __name__ == "__main__":
     test_infer_attr()
+    test_estimate_cost()
@@ -0,0 +1,136 @@
+"""Unittest cases for layout transform"""
+import numpy as np
+
+import tvm
+from tvm.contrib import graph_runtime
+import nnvm
+import nnvm.compiler
+from nnvm import symbol as sym
+from nnvm.compiler import graph_util, graph_attr
+from nnvm.testing.config import ctx_list
+
+
+def test_layout_transform_op():
+    x = sym.Variable("x")
+    y = sym.layout_transform(x, src_layout="NCHW", dst_layout="NCHW16c")
+    dtype = "float32"
+    dshape = (1, 32, 8, 8)
+    oshape = (1, 2, 8, 8, 16)
+    g = nnvm.graph.create(y)
+    _, out_shapes = graph_util.infer_shape(g, x=dshape)
+    assert tuple(out_shapes[0]) == oshape
+    for target, ctx in ctx_list():
+        graph, lib, _ = nnvm.compiler.build(y, target, {"x": dshape})
+        m = graph_runtime.create(graph, lib, ctx)
+        data = np.random.uniform(size=dshape).astype(dtype)
+        m.run(x=data)
+        out = m.get_output(0, tvm.nd.empty(oshape, dtype))
+        expected = data.reshape(1, 2, 16, 8, 8).transpose(0, 1, 3, 4, 2)
+        np.testing.assert_allclose(out.asnumpy(), expected)
+
+
+def test_layout_map_chain():
+    # the map operators stay blocked, a single transform at the output.
+    x1 = sym.Variable("x1")
+    x2 = sym.Variable("x2")
+    x3 = sym.Variable("x3")
+    y = sym.elemwise_add(sym.elemwise_add(x1, x2), x3)
+    g1 = nnvm.graph.create(y)
+    dshape = (1, 32, 8, 8)
+    g1 = graph_attr.set_shape_inputs(g1, {"x1": dshape, "x2": dshape, "x3": dshape})
+    g1 = graph_attr.set_layout_inputs(g1, {"x1": "NCHW16c", "x2": "NCHW16c", "x3": "NCHW16c"})
+    g1 = g1.apply("InferShape").apply("LayoutTransform")
+    y = sym.layout_transform(y, src_layout="NCHW16c", dst_layout="default")
+    g2 = nnvm.graph.create(y)
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_blocked_layout_propagation():
+    def before(x, bias):
+        y = sym.relu(x)
+        y = sym.max_pool2d(y, pool_size=(2, 2), strides=(2, 2), name="pool")
+        y = sym.broadcast_add(y, bias)
+        return y
+
+    def expected(x, bias):
+        bias = sym.layout_transform(bias, src_layout="default", dst_layout="CHW16c")
+        y = sym.relu(x)
+        y = sym.max_pool2d(y, pool_size=(2, 2), strides=(2, 2), name="pool")
+        y = sym.broadcast_add(y, bias)
+        y = sym.layout_transform(y, src_layout="NCHW16c", dst_layout="default")
+        return y
+
+    x = sym.Variable("x")
+    bias = sym.Variable("bias")
+    g1 = nnvm.graph.create(before(x, bias))
+    g1 = graph_attr.set_shape_inputs(g1, {"x": (1, 32, 8, 8), "bias": (32, 1, 1)})
+    g1 = graph_attr.set_layout_inputs(g1, {"x": "NCHW16c"})
+    g1 = g1.apply("InferShape").apply("LayoutTransform")
+    g2 = nnvm.graph.create(expected(x, bias))
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_broadcast_uncovered_blocked_axis():
+    # rhs does not cover the blocked channel, broadcast runs in default layout.
+    x = sym.Variable("x")
+    bias = sym.Variable("bias")
+    g1 = nnvm.graph.create(sym.broadcast_add(x, bias))
+    g1 = graph_attr.set_shape_inputs(g1, {"x": (1, 32, 8, 8), "bias": (8, 8)})
+    g1 = graph_attr.set_layout_inputs(g1, {"x": "NCHW16c"})
+    g1 = g1.apply("InferShape").apply("LayoutTransform")
+    y = sym.layout_transform(x, src_layout="NCHW16c", dst_layout="default")
+    g2 = nnvm.graph.create(sym.broadcast_add(y, bias))
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_layout_shared_transform():
+    # both consumers require default layout, the transform is shared.
+    x = sym.Variable("x")
+    y = sym.flatten(x) + sym.flatten(x * 2)
+    g1 = nnvm.graph.create(y)
+    g1 = graph_attr.set_shape_inputs(g1, {"x": (1, 32, 8, 8)})
+    g1 = graph_attr.set_layout_inputs(g1, {"x": "NCHW16c"})
+    g1 = g1.apply("InferShape").apply("LayoutTransform")
+    x = sym.layout_transform(x, src_layout="NCHW16c", dst_layout="default")
+    y = sym.flatten(x) + sym.flatten(x * 2)
+    g2 = nnvm.graph.create(y)
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_layout_cancel_inserted_transform():
+    # the transform in the graph cancels with the one inserted before it.
+    x = sym.Variable("x")
+    y = sym.layout_transform(x, src_layout="default", dst_layout="NCHW16c")
+    g1 = nnvm.graph.create(y)
+    g1 = graph_attr.set_shape_inputs(g1, {"x": (1, 32, 8, 8)})
+    g1 = graph_attr.set_layout_inputs(g1, {"x": "NCHW16c"})
+    g1 = g1.apply("InferShape").apply("LayoutTransform")
+    y = sym.layout_transform(x, src_layout="NCHW16c", dst_layout="default")
+    g2 = nnvm.graph.create(y)
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_build_layout():
+    x = sym.Variable("x")
+    y = sym.relu(x) + 1
+    dtype = "float32"
+    dshape = (1, 32, 8, 8)
+    for target, ctx in ctx_list():
+        graph, lib, _ = nnvm.compiler.build(
+            y, target, {"x": dshape}, layout={"x": "NCHW16c"})
+        m = graph_runtime.create(graph, lib, ctx)
+        data = np.random.uniform(-1, 1, size=dshape).astype(dtype)
+        # the input is fed in NCHW16c, the output is in NCHW.
+        m.run(x=data.reshape(1, 2, 16, 8, 8).transpose(0, 1, 3, 4, 2))
+        out = m.get_output(0, tvm.nd.empty(dshape, dtype))
+        np.testing.assert_allclose(out.asnumpy(), np.maximum(data, 0) + 1)
+
+
+if __name__ == "__main__":
+    test_layout_transform_op()
+    test_layout_map_chain()
+    test_blocked_layout_propagation()
+    test_broadcast_uncovered_blocked_axis()
+    test_layout_shared_transform()
+    test_layout_cancel_inserted_transform()
+    test_build_layout()
@@ -0,0 +1,116 @@
+"""Unittest cases for AutoMixedPrecision pass"""
+import numpy as np
+
+import tvm
+from tvm.contrib import graph_runtime
+import nnvm
+import nnvm.compiler
+from nnvm import symbol as sym
+from nnvm.compiler import graph_util, graph_attr
+from nnvm.testing.config import ctx_list
+
+
+def amp(y, allow_list=None, deny_list=None):
+    g = nnvm.graph.create(y)
+    g = graph_attr.set_dtype_inputs(g, "float32")
+    if allow_list is not None:
+        g._set_json_attr("amp_allow_list", allow_list, "list_str")
+    if deny_list is not None:
+        g._set_json_attr("amp_deny_list", deny_list, "list_str")
+    return g.apply("InferType").apply("AutoMixedPrecision")
+
+
+def test_amp_cast_boundary():
+    def before(x, w, b):
+        y = sym.conv2d(x, w, channels=4, kernel_size=(3, 3), use_bias=False, name="conv")
+        y = sym.relu(y)
+        y = sym.broadcast_add(y, b)
+        y = sym.flatten(y)
+        return sym.softmax(y)
+
+    def expected(x, w, b):
+        x = sym.cast(x, dtype="float16")
+        w = sym.cast(w, dtype="float16")
+        y = sym.conv2d(x, w, channels=4, kernel_size=(3, 3), use_bias=False, name="conv")
+        y = sym.relu(y)
+        y = sym.broadcast_add(y, sym.cast(b, dtype="float16"))
+        y = sym.flatten(y)
+        y = sym.cast(y, dtype="float32")
+        return sym.softmax(y)
+
+    x = sym.Variable("x")
+    w = sym.Variable("w")
+    b = sym.Variable("b")
+    g1 = amp(before(x, w, b))
+    g2 = nnvm.graph.create(expected(x, w, b))
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_amp_output_and_lists():
+    x = sym.Variable("x")
+    w = sym.Variable("w")
+    # the output is cast back to float32, the cast of x is shared.
+    y = sym.dense(x, w, units=4, use_bias=False) + sym.dense(x, w, units=4, use_bias=False)
+    g1 = amp(y)
+    xh = sym.cast(x, dtype="float16")
+    wh = sym.cast(w, dtype="float16")
+    y = sym.dense(xh, wh, units=4, use_bias=False) + sym.dense(xh, wh, units=4, use_bias=False)
+    g2 = nnvm.graph.create(sym.cast(y, dtype="float32"))
+    graph_util.check_graph_equal(g1, g2)
+
+    # nothing changes without allowed operators.
+    y = sym.dense(x, w, units=4, use_bias=False)
+    g1 = amp(y, allow_list=[])
+    graph_util.check_graph_equal(g1, nnvm.graph.create(y))
+
+    # relu runs in float32 when denied.
+    y = sym.relu(sym.dense(x, w, units=4, use_bias=False))
+    g1 = amp(y, deny_list=["relu"])
+    y = sym.dense(xh, wh, units=4, use_bias=False)
+    g2 = nnvm.graph.create(sym.relu(sym.cast(y, dtype="float32")))
+    graph_util.check_graph_equal(g1, g2)
+
+    # reductions run in float32 with a custom deny list.
+    y = sym.min(sym.dense(x, w, units=4, use_bias=False), axis=1)
+    g1 = amp(y, deny_list=["relu"])
+    y = sym.dense(xh, wh, units=4, use_bias=False)
+    g2 = nnvm.graph.create(sym.min(sym.cast(y, dtype="float32"), axis=1))
+    graph_util.check_graph_equal(g1, g2)
+
+
+def test_amp_build():
+    x = sym.Variable("x")
+    y = sym.conv2d(x, channels=4, kernel_size=(3, 3), padding=(1, 1), name="conv")
+    y = sym.relu(y)
+    y = sym.softmax(sym.flatten(y))
+    dshape = (1, 4, 8, 8)
+    oshape = (1, 256)
+    g = nnvm.graph.create(y)
+    ishape, _ = graph_util.infer_shape(g, x=dshape)
+    params = {}
+    for name, shape in zip(g.index.input_names, ishape):
+        if name != "x":
+            params[name] = tvm.nd.array(np.random.uniform(-1, 1, size=shape).astype("float32"))
+    data = np.random.uniform(size=dshape).astype("float32")
+    for target, ctx in ctx_list():
+        # float16 arithmetic is only checked on gpu.
+        if target != "cuda":
+            continue
+        outs = []
+        for add_pass in (None, ["AutoMixedPrecision"]):
+            with nnvm.compiler.build_config(add_pass=add_pass):
+                graph, lib, out_params = nnvm.compiler.build(
+                    y, target, {"x": dshape}, params=params)
+            if add_pass:
+                assert any(v.dtype == "float16" for v in out_params.values())
+            m = graph_runtime.create(graph, lib, ctx)
+            m.set_input(**out_params)
+            m.run(x=data)
+            outs.append(m.get_output(0, tvm.nd.empty(oshape)).asnumpy())
+        np.testing.assert_allclose(outs[1], outs[0], rtol=1e-2, atol=1e-3)
+
+
+if __name__ == "__main__":
+    test_amp_cast_boundary()
+    test_amp_output_and_lists()
+    test_amp_build()
@@ -0,0 +1,92 @@
+import numpy as np
+
+import tvm
+from tvm.contrib import util
+import nnvm.symbol as sym
+import nnvm.compiler
+
+
+def test_multi_batch():
+    x = sym.Variable("x")
+    y = sym.relu(sym.dense(x, units=16, name="fc"))
+    z = sym.sum(y, axis=0)
+    params = {
+        "fc_weight": tvm.nd.array(np.random.uniform(size=(16, 8)).astype("float32")),
+        "fc_bias": tvm.nd.array(np.random.uniform(size=(16,)).astype("float32")),
+    }
+    model = nnvm.compiler.build_multi_batch(
+        sym.Group([y, z]), "llvm", {"x": (1, 8)}, [4, 1, 4], params=params)
+    assert model.batch_sizes == [1, 4]
+    # the variants share one module
+    for graph in model.graphs.values():
+        for node in graph.index.nodes:
+            if node["op"] == "tvm_op" and not node["attrs"]["func_name"].startswith("__"):
+                assert model.lib.get_function(node["attrs"]["func_name"]) is not None
+
+    def verify(model):
+        dispatcher = model.dispatcher()
+        assert dispatcher.select(2) == 4
+        assert dispatcher.select(9) == 4
+        weight = params["fc_weight"].asnumpy()
+        bias = params["fc_bias"].asnumpy()
+        for n in [1, 4]:
+            data = np.random.uniform(size=(n, 8)).astype("float32")
+            out = dispatcher.run(x=data)
+            expected = np.maximum(data.dot(weight.T) + bias, 0)
+            np.testing.assert_allclose(out[0], expected, rtol=1e-5)
+            np.testing.assert_allclose(out[1], expected.sum(axis=0), rtol=1e-5)
+        # the sum over the batch would include the padding of 3 rows,
+        # or only the first chunk of 6 rows.
+        for n in [3, 6]:
+            data = np.random.uniform(size=(n, 8)).astype("float32")
+            try:
+                dispatcher.run(x=data)
+                assert False
+            except ValueError:
+                pass
+
+    verify(model)
+    temp = util.tempdir()
+    path = temp.relpath("model.bundle")
+    model.save(path)
+    loaded = nnvm.compiler.load_multi_batch(path)
+    assert loaded.batch_sizes == [1, 4]
+    verify(loaded)
+    # the largest variant is also a plain bundle
+    graph_json, _, _ = nnvm.compiler.load_bundle(path)
+    assert graph_json == model.graphs[4].json()
+
+
+def test_multi_batch_split():
+    x = sym.Variable("x")
+    y = sym.relu(sym.dense(x, units=16, name="fc"))
+    params = {
+        "fc_weight": tvm.nd.array(np.random.uniform(size=(16, 8)).astype("float32")),
+        "fc_bias": tvm.nd.array(np.random.uniform(size=(16,)).astype("float32")),
+    }
+    # the sum has shape (16,) in every variant, it is not batched in the 16 variant.
+    model = nnvm.compiler.build_multi_batch(
+        sym.Group([y, sym.sum(y, axis=0)]), "llvm", {"x": (1, 8)}, [1, 16], params=params)
+    dispatcher = model.dispatcher()
+    data = np.random.uniform(size=(16, 8)).astype("float32")
+    out = dispatcher.run(x=data)
+    expected = np.maximum(data.dot(params["fc_weight"].asnumpy().T) +
+                          params["fc_bias"].asnumpy(), 0)
+    np.testing.assert_allclose(out[1], expected.sum(axis=0), rtol=1e-5)
+
+    # all the outputs are batched, the batches are padded and split.
+    model = nnvm.compiler.build_multi_batch(
+        y, "llvm", {"x": (1, 8)}, [1, 4], params=params)
+    dispatcher = model.dispatcher()
+    for n in [3, 6, 9]:
+        data = np.random.uniform(size=(n, 8)).astype("float32")
+        out = dispatcher.run(x=data)
+        expected = np.maximum(data.dot(params["fc_weight"].asnumpy().T) +
+                              params["fc_bias"].asnumpy(), 0)
+        assert out[0].shape == (n, 16)
+        np.testing.assert_allclose(out[0], expected, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_multi_batch()
+    test_multi_batch_split()
@@ -77,7 +77,27 @@ def test_injective_reduce_injective():
         np.testing.assert_allclose(out.asnumpy(), c_np, rtol=1e-5)
 
 
+def test_fused_op_profile():
+    x = sym.Variable("x")
+    y = sym.conv2d(x, channels=8, kernel_size=(3, 3), padding=(1, 1),
+                   use_bias=False, name="conv")
+    y = sym.relu(y, name="relu")
+    y = sym.dense(sym.flatten(y, name="flatten"), units=4, use_bias=False, name="fc")
+    dshape = (1, 4, 8, 8)
+    graph, lib, _ = nnvm.compiler.build(y, "llvm", {"x": dshape})
+    profile = nnvm.compiler.profile_fused_ops(graph, lib, number=2)
+    # the fused op is named after the last node of the group.
+    fused = {p["name"]: p for p in profile}
+    assert fused["relu"]["fused_nodes"] == ["conv", "relu"]
+    # 2 * output size * reduction size, plus one per relu output.
+    assert fused["relu"]["flop"] == 2 * 8 * 8 * 8 * 4 * 9 + 8 * 8 * 8
+    assert fused["fc"]["flop"] == 2 * 4 * 8 * 8 * 8
+    assert all(p["time_ms"] > 0 for p in profile)
+    assert "conv,relu" in nnvm.compiler.format_profile(profile)
+
+
 if __name__ == "__main__":
+    test_fused_op_profile()
     test_injective_reduce_injective()
     test_ewise_injective()
     test_conv_ewise_injective()
@@ -1,4 +1,8 @@
+import gc
+import os
 import numpy as np
+import tvm
+from tvm.contrib import util
 import nnvm.compiler
 
 def test_save_load():
@@ -15,5 +19,99 @@ def test_save_load():
     np.testing.assert_equal(param2["y"].asnumpy(), y)
 
 
+def test_save_load_file():
+    x = np.random.uniform(size=(10, 2)).astype("float32")
+    y = np.random.randint(0, 10, size=(1, 2, 3)).astype("int32")
+    z = np.zeros((0, 4), dtype="float32")
+    params = {"x": x, "y": y, "z": z}
+    temp = util.tempdir()
+    path = temp.relpath("deploy.params")
+    nnvm.compiler.save_param_file(params, path)
+    for mmap in (True, False):
+        param2 = nnvm.compiler.load_param_file(path, mmap=mmap)
+        assert len(param2) == 3
+        np.testing.assert_equal(param2["x"].asnumpy(), x)
+        np.testing.assert_equal(param2["y"].asnumpy(), y)
+        assert param2["z"].shape == z.shape
+    # the arrays are views of the mapping, writes do not reach the file.
+    param2 = nnvm.compiler.load_param_file(path)
+    param2["x"].copyfrom(np.zeros_like(x))
+    np.testing.assert_equal(nnvm.compiler.load_param_file(path)["x"].asnumpy(), x)
+    # the file content can also be loaded as bytes.
+    with open(path, "rb") as fi:
+        param3 = nnvm.compiler.load_param_dict(fi.read())
+    np.testing.assert_equal(param3["y"].asnumpy(), y)
+
+
+def test_mapped_array_lifetime():
+    x = np.random.uniform(size=(10, 2)).astype("float32")
+    temp = util.tempdir()
+    path = temp.relpath("deploy.params")
+    nnvm.compiler.save_param_file({"x": x}, path)
+    # the arrays keep the mapping alive without the returned dict.
+    arr = dict(nnvm.compiler.load_param_file(path))["x"]
+    gc.collect()
+    np.testing.assert_equal(arr.asnumpy(), x)
+
+
+def test_load_file_stream():
+    x = np.random.uniform(size=(3000, 2000)).astype("float32")
+    y = np.random.uniform(size=(5, 7)).astype("float32")
+    params = {"x": x, "y": y}
+    temp = util.tempdir()
+    path = temp.relpath("deploy.params")
+    nnvm.compiler.save_param_file(params, path)
+    for nthread in (1, 4):
+        param2 = nnvm.compiler.load_param_file(path, mmap=False, nthread=nthread)
+        np.testing.assert_equal(param2["x"].asnumpy(), x)
+        np.testing.assert_equal(param2["y"].asnumpy(), y)
+    # read into preallocated arrays.
+    out = {"x": tvm.nd.empty(x.shape)}
+    nnvm.compiler.load_param_file(path, out=out, nthread=2)
+    np.testing.assert_equal(out["x"].asnumpy(), x)
+    # the list format can be streamed as well.
+    path = temp.relpath("deploy_list.params")
+    with open(path, "wb") as fo:
+        fo.write(nnvm.compiler.save_param_dict(params))
+    param2 = nnvm.compiler.load_param_file(path, mmap=False)
+    np.testing.assert_equal(param2["y"].asnumpy(), y)
+
+
+def test_save_file_dedup_codec():
+    x = np.random.uniform(size=(64, 64)).astype("float32")
+    y = np.random.uniform(-10, 10, size=(64, 64)).astype("float32")
+    z = np.arange(16).astype("int32")
+    temp = util.tempdir()
+    path1 = temp.relpath("one.params")
+    path2 = temp.relpath("tied.params")
+    nnvm.compiler.save_param_file({"x": x}, path1)
+    nnvm.compiler.save_param_file({"x": x, "x_tied": x.copy()}, path2)
+    assert os.path.getsize(path1) == os.path.getsize(path2)
+    for mmap in (True, False):
+        param = nnvm.compiler.load_param_file(path2, mmap=mmap)
+        np.testing.assert_equal(param["x_tied"].asnumpy(), x)
+    # float16 storage, upcast on load, int tensors are kept.
+    path3 = temp.relpath("half.params")
+    nnvm.compiler.save_param_file({"x": x, "y": y, "z": z}, path3, codec="float16")
+    path4 = temp.relpath("half_x.params")
+    nnvm.compiler.save_param_file({"x": x, "y": y}, path4, codec={"x": "float16"})
+    for mmap in (True, False):
+        param = nnvm.compiler.load_param_file(path3, mmap=mmap)
+        assert param["x"].dtype == "float32"
+        np.testing.assert_equal(param["x"].asnumpy(), x.astype("float16").astype("float32"))
+        np.testing.assert_equal(param["y"].asnumpy(), y.astype("float16").astype("float32"))
+        np.testing.assert_equal(param["z"].asnumpy(), z)
+        param = nnvm.compiler.load_param_file(path4, mmap=mmap)
+        np.testing.assert_equal(param["x"].asnumpy(), x.astype("float16").astype("float32"))
+        np.testing.assert_equal(param["y"].asnumpy(), y)
+    with open(path3, "rb") as fi:
+        param = nnvm.compiler.load_param_dict(fi.read())
+    np.testing.assert_equal(param["y"].asnumpy(), y.astype("float16").astype("float32"))
+
+
 if __name__ == "__main__":
     test_save_load()
+    test_save_load_file()
+    test_mapped_array_lifetime()
+    test_load_file_stream()
+    test_save_file_dedup_codec()
@@ -0,0 +1,81 @@
+"""Unittest cases for int8 quantization"""
+import numpy as np
+
+import tvm
+from tvm.contrib import graph_runtime
+import nnvm
+import nnvm.compiler
+import nnvm.testing
+from nnvm import symbol as sym
+
+
+def test_quantize_graph():
+    x = sym.Variable("x")
+    y = sym.conv2d(x, channels=4, kernel_size=(3, 3), padding=(1, 1), name="conv")
+    y = sym.relu(y)
+    y = sym.flatten(y)
+    y = sym.dense(y, units=10, name="fc")
+    y = sym.dense(y, units=10, name="fc_float")
+    g = nnvm.compiler.quantize(y, {"conv": 1.0, "fc": 2.0})
+    ops = [node["op"] for node in g.index.nodes]
+    assert ops.count("quantize") == 4
+    for node in g.index.nodes:
+        if node["name"] in ("conv", "fc"):
+            assert node["attrs"]["out_dtype"] == "int32"
+            assert node["attrs"]["use_bias"] == "false"
+        if node["name"] == "fc_float":
+            assert "out_dtype" not in node.get("attrs", {})
+    _, dtypes = nnvm.compiler.graph_util.infer_dtype(g, x="float32")
+    assert dtypes[0] == "float32"
+
+
+def verify_quantize(net, params, shape, tol):
+    target, ctx = "llvm", tvm.cpu(0)
+    dataset = [{"data": np.random.uniform(size=shape).astype("float32")}
+               for _ in range(4)]
+    ranges = nnvm.compiler.calibrate(net, dataset, {"data": shape}, params)
+    assert all(v > 0 for v in ranges.values())
+    qgraph = nnvm.compiler.quantize(net, ranges)
+    oshape = nnvm.compiler.graph_util.infer_shape(
+        nnvm.graph.create(net), data=shape)[1][0]
+
+    def run(graph):
+        graph, lib, out_params = nnvm.compiler.build(
+            graph, target, {"data": shape}, params=params)
+        m = graph_runtime.create(graph, lib, ctx)
+        m.set_input(**out_params)
+        m.run(data=dataset[0]["data"])
+        return m.get_output(0, tvm.nd.empty(oshape)).asnumpy(), out_params
+
+    expected, _ = run(net)
+    out, qparams = run(qgraph)
+    assert any(v.dtype == "int8" for v in qparams.values())
+    np.testing.assert_allclose(out, expected, atol=tol * np.abs(expected).max())
+
+
+def test_quantize_mlp():
+    net, params = nnvm.testing.mlp.get_workload(batch_size=1, num_classes=10)
+    verify_quantize(net, params, (1, 3, 224, 224), 0.05)
+
+
+def test_quantize_conv():
+    data = sym.Variable("data")
+    y = sym.conv2d(data, channels=8, kernel_size=(3, 3), padding=(1, 1), name="conv1")
+    y = sym.relu(y)
+    y = sym.conv2d(y, channels=8, kernel_size=(3, 3), padding=(1, 1), name="conv2")
+    y = sym.flatten(y)
+    y = sym.dense(y, units=10, name="fc")
+    shape = (1, 4, 8, 8)
+    params = {}
+    g = nnvm.graph.create(y)
+    ishape, _ = nnvm.compiler.graph_util.infer_shape(g, data=shape)
+    for name, s in zip(g.index.input_names, ishape):
+        if name != "data":
+            params[name] = tvm.nd.array(np.random.uniform(-1, 1, size=s).astype("float32"))
+    verify_quantize(y, params, shape, 0.05)
+
+
+if __name__ == "__main__":
+    test_quantize_graph()
+    test_quantize_mlp()
+    test_quantize_conv()
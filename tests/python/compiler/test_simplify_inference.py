@@ -46,5 +46,34 @@ def test_simplify_batchnorm():
     check(4, 0, 3)
     check(4, 1, 2)
 
+def test_simplify_carry_shape():
+    x = sym.Variable("x")
+    y = sym.batch_norm(sym.relu(x), name="bn")
+    y = sym.dense(sym.flatten(y), units=4, name="fc")
+    g = nnvm.graph.create(y)
+    ishape = {"x": (2, 3, 4, 4)}
+    graph_attr.set_shape_inputs(g, ishape)
+    g1 = g.apply("InferShape").apply("SimplifyInference")
+    # the shapes of the entries kept by the pass are carried over
+    seed = g1.json_attr("shape_seed")
+    assert seed is not None
+    assert [] in seed
+    assert [2, 4] in seed
+    for shape in [ishape, {"x": (5, 3, 4, 4)}]:
+        graph_attr.set_shape_inputs(g1, shape)
+        _, oshape = graph_util.infer_shape(g1, **shape)
+        # same as the inference from scratch.
+        g2 = nnvm.graph.create(g1.symbol)
+        _, expected = graph_util.infer_shape(g2, **shape)
+        assert oshape == expected
+        assert oshape[0] == [shape["x"][0], 4]
+    # a seed that does not match the graph is discarded.
+    g3 = nnvm.graph.create(g1.symbol)
+    g3._set_json_attr("shape_seed", [[1]], "list_shape")
+    _, oshape = graph_util.infer_shape(g3, **ishape)
+    assert oshape[0] == [2, 4]
+
+
 if __name__ == "__main__":
     test_simplify_batchnorm()
+    test_simplify_carry_shape()
@@ -28,6 +28,28 @@ def test_json_pass_with_attr():
     assert g2.json_attr('version') == '0.1.0'
 
 
+def test_binary_pass():
+    x = sym.Variable('x', shape=(4, 10))
+    y = sym.dense(data=x, name='fc', units=30)
+    y = sym.relu(y) + sym.dense(data=x, name='fc2', units=30)
+    y = sym.log_softmax(y)
+    g = graph.create(y)
+    g._set_json_attr('version', '0.1.0')
+    g._set_json_attr('ilist', [1, -2, 300], 'list_int')
+    g._set_json_attr('dlist', {'a': 1}, 'dict_str_int')
+    g._set_json_attr("shape_attr_key", "shape")
+    g = g.apply('InferShape')
+    data = g.binary()
+    assert isinstance(data, bytes)
+    assert len(data) < len(g.json())
+    g2 = graph.load_binary(data)
+    assert json.loads(g2.json()) == json.loads(g.json())
+    assert g2.json_attr('shape') == g.json_attr('shape')
+    assert g2.json_attr('ilist') == [1, -2, 300]
+    assert g2.json_attr('dlist') == {'a': 1}
+    assert g2.binary() == data
+
+
 def test_graph_json_attr():
     x = sym.Variable('x')
     y = sym.dense(data=x, name='fc', units=30)
@@ -103,6 +125,72 @@ def test_plan_memory():
     assert (storage_id[jnode_row_ptr[nindex["add2"]]] ==
             storage_id[jnode_row_ptr[nindex["reshapek"]]])
 
+def test_parallel_schedule():
+    x = sym.Variable('x', shape=(4, 2))
+    a = sym.exp(x, name='a')
+    a2 = sym.elemwise_add(a, a, name='a2')
+    b = sym.log(x, name='b')
+    b2 = sym.log(b, name='b2')
+    y = sym.elemwise_add(a2, b2, name='add')
+    g = graph.create(y)
+    g._set_json_attr("shape_attr_key", "shape")
+    g = g.apply(["InferShape", "InferType"])
+    nindex = {n['name']: i for i, n in enumerate(g.index.nodes)}
+    eid = lambda name: g.index.entry_id(name)
+    # sequentially, b reuses the buffer of a after a2.
+    storage_id = g.apply("PlanMemory").json_attr('storage_id')
+    assert storage_id[eid("a")] == storage_id[eid("b")]
+    g._set_json_attr("num_streams", 2, "int")
+    g = g.apply(["ParallelSchedule", "PlanMemory"])
+    level = g.json_attr("node_level")
+    assert [level[nindex[k]] for k in ["x", "a", "b", "a2", "b2", "add"]] == [-1, 0, 0, 1, 1, 2]
+    dep_count = g.json_attr("node_dep_count")
+    assert dep_count[nindex["a"]] == 0
+    assert dep_count[nindex["a2"]] == 1
+    assert dep_count[nindex["add"]] == 2
+    stream = g.json_attr("node_stream")
+    assert stream[nindex["a"]] == stream[nindex["a2"]]
+    assert stream[nindex["b"]] == stream[nindex["b2"]]
+    assert stream[nindex["a"]] != stream[nindex["b"]]
+    # a is still in use by a2 of the level of b2, so no buffer is shared.
+    storage_id = g.json_attr('storage_id')
+    assert storage_id[eid("a")] != storage_id[eid("b")]
+    assert storage_id[eid("a")] != storage_id[eid("b2")]
+
+def test_pass_dependency():
+    x = sym.Variable('x')
+    y = sym.flatten(sym.elemwise_add(x, x, name='addk'), name="reshapek")
+    g = graph.create(y)
+    g._set_json_attr("shape_inputs", [[4, 2]], 'list_shape')
+    # InferShape and InferType are applied for PlanMemory.
+    g = g.apply("PlanMemory")
+    assert g.json_attr('shape')[-1] == [4, 2]
+    assert g.json_attr('storage_id') is not None
+    # pending inputs are inferred again.
+    g._set_json_attr("shape_inputs", [[8, 2]], 'list_shape')
+    g = g.apply(["InferShape", "InferShape", "PlanMemory"])
+    assert g.json_attr('shape')[-1] == [8, 2]
+
+def test_pass_profile():
+    x = sym.Variable('x', shape=(4, 2))
+    y = sym.flatten(sym.elemwise_add(x, x, name='addk'), name="reshapek")
+    g = graph.create(y)
+    g._set_json_attr("shape_attr_key", "shape")
+    g1 = g.apply(["InferShape", "SaveJSON"], profile=True)
+    profile = g1.json_attr("pass_profile")
+    assert [p["name"] for p in profile] == ["InferShape", "SaveJSON"]
+    assert profile[0]["num_nodes_before"] == 3
+    assert profile[0]["num_entries_after"] == 3
+    assert all(p["time_ms"] >= 0 for p in profile)
+    # not recorded by default.
+    assert g.apply("InferShape").json_attr("pass_profile") is None
+    # the graph saved by a profiled run does not turn profiling on when loaded.
+    json_str = g1.json_attr("json")
+    assert "pass_profile" not in json_str
+    g2 = graph.load_json(json_str)
+    g2._set_json_attr("shape_attr_key", "shape")
+    assert g2.apply("InferShape").json_attr("pass_profile") is None
+
 def test_print_graph_ir():
     x = sym.Variable("x", shape=(1, 1, 10, 20))
     y = sym.conv2d(x + 1, name="y", channels=10, kernel_size=(3,3))
@@ -136,9 +224,13 @@ if __name__ == "__main__":
     test_json_pass_with_attr()
     test_graph_json_attr()
     test_json_pass()
+    test_binary_pass()
     test_infer_shape()
     test_infer_shape_known_partial()
     test_infer_type()
     test_plan_memory()
+    test_parallel_schedule()
+    test_pass_dependency()
+    test_pass_profile()
     test_list_args()
     test_gradient()